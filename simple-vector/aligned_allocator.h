@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Аллокатор, выделяющий память с выравниванием Alignment байт (степень двойки, не меньше alignof(T)).
+// С ним начало буфера SimpleVector гарантированно выровнено, например, по строке кэша
+// или по ширине векторного регистра для выровненных загрузок
+template <typename T, size_t Alignment>
+class AlignedAllocator {
+    static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t kAlignment = Alignment;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, std::max(Alignment, alignof(U))>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U, size_t OtherAlignment>
+    AlignedAllocator(const AlignedAllocator<U, OtherAlignment>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T* ptr, size_t /*n*/) noexcept {
+        ::operator delete(ptr, std::align_val_t{Alignment});
+    }
+
+    template <typename U, size_t OtherAlignment>
+    bool operator==(const AlignedAllocator<U, OtherAlignment>&) const noexcept {
+        return true;
+    }
+
+    template <typename U, size_t OtherAlignment>
+    bool operator!=(const AlignedAllocator<U, OtherAlignment>&) const noexcept {
+        return false;
+    }
+};
+
+namespace simple_vector_detail {
+
+// Гарантированное выравнивание начала буфера, выделенного аллокатором:
+// Allocator::kAlignment, если он его объявляет, иначе alignof(value_type)
+template <typename Allocator, typename = void>
+struct AllocatorAlignment
+    : std::integral_constant<size_t, alignof(typename std::allocator_traits<Allocator>::value_type)> {};
+
+template <typename Allocator>
+struct AllocatorAlignment<Allocator, std::void_t<decltype(Allocator::kAlignment)>>
+    : std::integral_constant<size_t, Allocator::kAlignment> {};
+
+} // namespace simple_vector_detail
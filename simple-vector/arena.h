@@ -0,0 +1,364 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+// Линейная (bump) арена: память выделяется сдвигом указателя внутри блока,
+// отдельные освобождения почти бесплатны, вся память возвращается разом в Reset().
+// Арена не потокобезопасна: каждому потоку — своя арена (см. ThreadLocalArena()).
+class BumpArena {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit BumpArena(size_t block_size = kDefaultBlockSize) noexcept
+        : block_size_(block_size) {
+    }
+
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+
+    ~BumpArena() {
+        FreeBlocks(nullptr);
+    }
+
+    // Выделяет bytes байт с выравниванием alignment (степень двойки).
+    // Если в текущем блоке не хватает места, заводится новый блок
+    void* Allocate(size_t bytes, size_t alignment) {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        std::byte* result = AlignUp(top_, alignment);
+        if (current_ == nullptr || result > limit_ || bytes > static_cast<size_t>(limit_ - result)) {
+            AddBlock(bytes, alignment);
+            result = AlignUp(top_, alignment);
+        }
+        top_ = result + bytes;
+        last_ = result;
+        return result;
+    }
+
+    // Возвращает память в арену, только если это последнее выделение
+    void Deallocate(void* ptr, size_t /*bytes*/) noexcept {
+        if (ptr != nullptr && ptr == last_) {
+            top_ = last_;
+            last_ = nullptr;
+        }
+    }
+
+    // Расширяет на месте последнее выделение ptr с old_bytes до new_bytes байт.
+    // Возвращает false, если ptr выделен не последним или место в блоке закончилось
+    bool TryExpand(void* ptr, size_t old_bytes, size_t new_bytes) noexcept {
+        std::byte* base = static_cast<std::byte*>(ptr);
+        if (ptr == nullptr || base != last_ || top_ != base + old_bytes) {
+            return false;
+        }
+        if (new_bytes > static_cast<size_t>(limit_ - base)) {
+            return false;
+        }
+        top_ = base + new_bytes;
+        return true;
+    }
+
+    // Освобождает все выделения сразу. Самый большой блок остаётся для повторного использования
+    void Reset() noexcept {
+        Block* largest = current_;
+        for (Block* block = current_; block != nullptr; block = block->prev) {
+            if (block->size > largest->size) {
+                largest = block;
+            }
+        }
+        FreeBlocks(largest);
+        current_ = largest;
+        if (largest != nullptr) {
+            largest->prev = nullptr;
+            top_ = largest->Data();
+            limit_ = top_ + largest->size;
+        } else {
+            top_ = limit_ = nullptr;
+        }
+        last_ = nullptr;
+    }
+
+    // Возвращает количество байт, занятых в блоках арены
+    size_t GetReservedBytes() const noexcept {
+        size_t total = 0;
+        for (Block* block = current_; block != nullptr; block = block->prev) {
+            total += block->size;
+        }
+        return total;
+    }
+
+private:
+    struct alignas(std::max_align_t) Block {
+        Block* prev;
+        size_t size;
+
+        std::byte* Data() noexcept {
+            return reinterpret_cast<std::byte*>(this + 1);
+        }
+    };
+
+    static std::byte* AlignUp(std::byte* ptr, size_t alignment) noexcept {
+        if (ptr == nullptr) {
+            return nullptr;
+        }
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto aligned = (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        return ptr + (aligned - address);
+    }
+
+    void AddBlock(size_t bytes, size_t alignment) {
+        if (bytes > std::numeric_limits<size_t>::max() - alignment - sizeof(Block)) {
+            throw std::bad_alloc();
+        }
+        const size_t size = std::max(block_size_, bytes + alignment);
+        void* memory = ::operator new(sizeof(Block) + size);
+        Block* block = new (memory) Block{current_, size};
+        current_ = block;
+        top_ = block->Data();
+        limit_ = top_ + size;
+        last_ = nullptr;
+    }
+
+    // Освобождает все блоки, кроме keep
+    void FreeBlocks(Block* keep) noexcept {
+        Block* block = current_;
+        while (block != nullptr) {
+            Block* prev = block->prev;
+            if (block != keep) {
+                ::operator delete(block);
+            }
+            block = prev;
+        }
+    }
+
+    size_t block_size_;
+    Block* current_ = nullptr;
+    std::byte* top_ = nullptr;
+    std::byte* limit_ = nullptr;
+    // начало последнего выделения: только его можно вернуть или расширить на месте
+    std::byte* last_ = nullptr;
+};
+
+// Арена текущего потока: для временных буферов, живущих в пределах одного кадра или запроса
+inline BumpArena& ThreadLocalArena() {
+    thread_local BumpArena arena;
+    return arena;
+}
+
+// Пул блоков фиксированных классов размера (степени двойки от 16 до kMaxPooledSize байт).
+// Освобождённые блоки попадают в список свободных своего класса и переиспользуются.
+// Выделения крупнее kMaxPooledSize или с выравниванием больше kPoolAlignment идут в operator new.
+// Пул не потокобезопасен: память должна освобождаться в том же потоке (см. ThreadLocalPool())
+class SizeClassPool {
+public:
+    static constexpr size_t kMinPooledSize = 16;
+    static constexpr size_t kMaxPooledSize = 64 * 1024;
+    static constexpr size_t kPoolAlignment = alignof(std::max_align_t);
+    static constexpr size_t kSlabSize = 256 * 1024;
+
+    SizeClassPool() = default;
+    SizeClassPool(const SizeClassPool&) = delete;
+    SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+    ~SizeClassPool() {
+        while (slabs_ != nullptr) {
+            Slab* next = slabs_->next;
+            ::operator delete(slabs_);
+            slabs_ = next;
+        }
+    }
+
+    void* Allocate(size_t bytes, size_t alignment) {
+        if (bytes > kMaxPooledSize || alignment > kPoolAlignment) {
+            return ::operator new(bytes, std::align_val_t{std::max(alignment, kPoolAlignment)});
+        }
+        const size_t index = SizeClassIndex(bytes);
+        if (free_lists_[index] == nullptr) {
+            Refill(index);
+        }
+        FreeNode* node = free_lists_[index];
+        free_lists_[index] = node->next;
+        return node;
+    }
+
+    void Deallocate(void* ptr, size_t bytes, size_t alignment) noexcept {
+        if (ptr == nullptr) {
+            return;
+        }
+        if (bytes > kMaxPooledSize || alignment > kPoolAlignment) {
+            ::operator delete(ptr, std::align_val_t{std::max(alignment, kPoolAlignment)});
+            return;
+        }
+        const size_t index = SizeClassIndex(bytes);
+        FreeNode* node = static_cast<FreeNode*>(ptr);
+        node->next = free_lists_[index];
+        free_lists_[index] = node;
+    }
+
+    // Возвращает размер класса, в который попадёт выделение bytes байт
+    static size_t SizeClassOf(size_t bytes) noexcept {
+        return kMinPooledSize << SizeClassIndex(bytes);
+    }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    struct alignas(std::max_align_t) Slab {
+        Slab* next;
+    };
+
+    static constexpr size_t kClassCount = 13;  // 16 B ... 64 KiB
+    static_assert((kMinPooledSize << (kClassCount - 1)) == kMaxPooledSize);
+
+    static size_t SizeClassIndex(size_t bytes) noexcept {
+        size_t index = 0;
+        size_t size = kMinPooledSize;
+        while (size < bytes) {
+            size <<= 1;
+            ++index;
+        }
+        return index;
+    }
+
+    // Нарезает новый слэб на блоки класса index
+    void Refill(size_t index) {
+        const size_t block = kMinPooledSize << index;
+        const size_t count = std::max(kSlabSize / block, static_cast<size_t>(1));
+        void* memory = ::operator new(sizeof(Slab) + block * count);
+        Slab* slab = new (memory) Slab{slabs_};
+        slabs_ = slab;
+        std::byte* data = reinterpret_cast<std::byte*>(slab + 1);
+        for (size_t i = count; i > 0; --i) {
+            FreeNode* node = reinterpret_cast<FreeNode*>(data + (i - 1) * block);
+            node->next = free_lists_[index];
+            free_lists_[index] = node;
+        }
+    }
+
+    FreeNode* free_lists_[kClassCount] = {};
+    Slab* slabs_ = nullptr;
+};
+
+// Пул текущего потока
+inline SizeClassPool& ThreadLocalPool() {
+    thread_local SizeClassPool pool;
+    return pool;
+}
+
+// Аллокатор поверх BumpArena. Неявно создаётся из арены, поэтому вектор
+// можно построить прямо от неё: SimpleVector<int, ArenaAllocator<int>> v(arena);
+// Умеет расширять последнее выделение на месте (Expand), чем пользуется SimpleVector::Reserve
+template <typename Type>
+class ArenaAllocator {
+public:
+    using value_type = Type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    ArenaAllocator() noexcept
+        : arena_(&ThreadLocalArena()) {
+    }
+
+    ArenaAllocator(BumpArena& arena) noexcept
+        : arena_(&arena) {
+    }
+
+    template <typename Other>
+    ArenaAllocator(const ArenaAllocator<Other>& other) noexcept
+        : arena_(other.GetArena()) {
+    }
+
+    Type* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<Type*>(arena_->Allocate(count * sizeof(Type), alignof(Type)));
+    }
+
+    void deallocate(Type* ptr, size_t count) noexcept {
+        arena_->Deallocate(ptr, count * sizeof(Type));
+    }
+
+    // Расширяет выделение ptr с old_count до new_count элементов без переноса
+    bool Expand(Type* ptr, size_t old_count, size_t new_count) noexcept {
+        if (new_count > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            return false;
+        }
+        return arena_->TryExpand(ptr, old_count * sizeof(Type), new_count * sizeof(Type));
+    }
+
+    BumpArena* GetArena() const noexcept {
+        return arena_;
+    }
+
+    template <typename Other>
+    bool operator==(const ArenaAllocator<Other>& other) const noexcept {
+        return arena_ == other.GetArena();
+    }
+
+    template <typename Other>
+    bool operator!=(const ArenaAllocator<Other>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    BumpArena* arena_;
+};
+
+// Аллокатор поверх SizeClassPool
+template <typename Type>
+class PoolAllocator {
+public:
+    using value_type = Type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    PoolAllocator() noexcept
+        : pool_(&ThreadLocalPool()) {
+    }
+
+    PoolAllocator(SizeClassPool& pool) noexcept
+        : pool_(&pool) {
+    }
+
+    template <typename Other>
+    PoolAllocator(const PoolAllocator<Other>& other) noexcept
+        : pool_(other.GetPool()) {
+    }
+
+    Type* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<Type*>(pool_->Allocate(count * sizeof(Type), alignof(Type)));
+    }
+
+    void deallocate(Type* ptr, size_t count) noexcept {
+        pool_->Deallocate(ptr, count * sizeof(Type), alignof(Type));
+    }
+
+    SizeClassPool* GetPool() const noexcept {
+        return pool_;
+    }
+
+    template <typename Other>
+    bool operator==(const PoolAllocator<Other>& other) const noexcept {
+        return pool_ == other.GetPool();
+    }
+
+    template <typename Other>
+    bool operator!=(const PoolAllocator<Other>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    SizeClassPool* pool_;
+};
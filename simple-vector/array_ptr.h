@@ -1,88 +1,296 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
 #include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
+#include "config.h"
+#include "stats.h"
+
+namespace simple_vector_detail {
+
+// Хранит аллокатор. Пустые аллокаторы (std::allocator) хранятся как базовый класс
+// и не увеличивают размер владельца
+template <typename Allocator, bool = std::is_empty_v<Allocator> && !std::is_final_v<Allocator>>
+class AllocatorHolder {
+public:
+    AllocatorHolder() = default;
+
+    SIMPLE_VECTOR_CONSTEXPR explicit AllocatorHolder(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Allocator& GetAllocator() noexcept {
+        return alloc_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    Allocator alloc_;
+};
+
+template <typename Allocator>
+class AllocatorHolder<Allocator, true> : private Allocator {
+public:
+    AllocatorHolder() = default;
+
+    SIMPLE_VECTOR_CONSTEXPR explicit AllocatorHolder(const Allocator& alloc) noexcept
+        : Allocator(alloc) {
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Allocator& GetAllocator() noexcept {
+        return *this;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Allocator& GetAllocator() const noexcept {
+        return *this;
+    }
+};
+
+// Проверяет, умеет ли аллокатор расширять выделенную память на месте:
+// bool Expand(Type* ptr, size_t old_count, size_t new_count)
+template <typename Allocator, typename Type, typename = void>
+struct HasExpand : std::false_type {};
+
+template <typename Allocator, typename Type>
+struct HasExpand<Allocator, Type, std::void_t<decltype(std::declval<Allocator&>().Expand(
+    std::declval<Type*>(), std::declval<size_t>(), std::declval<size_t>()))>> : std::true_type {};
+
+// Освобождает чужой буфер, принятый вектором без копирования (SimpleVector::Adopt).
+// Стирает тип функции освобождения: ArrayPtr хранит лишь указатель на этот объект
 template <typename Type>
-class ArrayPtr {
+class BufferDeleter {
+public:
+    virtual ~BufferDeleter() = default;
+
+    virtual void Delete(Type* ptr, size_t capacity) noexcept = 0;
+};
+
+// Deleter вызывается как deleter(ptr, capacity) или deleter(ptr)
+template <typename Type, typename Deleter>
+class BufferDeleterImpl final : public BufferDeleter<Type> {
+public:
+    explicit BufferDeleterImpl(Deleter deleter)
+        : deleter_(std::move(deleter)) {
+    }
+
+    void Delete(Type* ptr, size_t capacity) noexcept override {
+        if constexpr (std::is_invocable_v<Deleter&, Type*, size_t>) {
+            deleter_(ptr, capacity);
+        } else {
+            deleter_(ptr);
+        }
+    }
+
+private:
+    Deleter deleter_;
+};
+
+} // namespace simple_vector_detail
+
+template <typename Type, typename Allocator = std::allocator<Type>>
+class ArrayPtr : private simple_vector_detail::AllocatorHolder<Allocator> {
+    using Holder = simple_vector_detail::AllocatorHolder<Allocator>;
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, Type>,
+                  "Allocator::value_type must be the same as Type");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, Type*>,
+                  "Allocators with fancy pointers are not supported");
+
 public:
+    using allocator_type = Allocator;
+
     // Инициализирует ArrayPtr нулевым указателем
     ArrayPtr() = default;
 
-    // Создаёт в куче массив из size элементов типа Type.
+    // Инициализирует ArrayPtr нулевым указателем и запоминает аллокатор
+    SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(const Allocator& alloc) noexcept
+        : Holder(alloc) {
+    }
+
+    // Выделяет через аллокатор неинициализированную память под size элементов типа Type.
+    // Объекты в этой памяти не создаются:
+    // их конструирование и разрушение — забота владельца (SimpleVector).
     // Если size == 0, поле raw_ptr_ должно быть равно nullptr
-    explicit ArrayPtr(size_t size) {
+    SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(size_t size, const Allocator& alloc = Allocator())
+        : Holder(alloc) {
         if (size == 0) {
             raw_ptr_ = nullptr;
         } else {
-            raw_ptr_ = new Type[size];
+            if (size > AllocTraits::max_size(GetAllocator())) {
+                throw std::bad_array_new_length();
+            }
+            raw_ptr_ = AllocTraits::allocate(GetAllocator(), size);
+            size_ = size;
+            simple_vector_detail::RecordStats<Type>([size](auto& stats) {
+                stats.RecordAllocation(size * sizeof(Type));
+            });
         }
     }
 
-    // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr
-    explicit ArrayPtr(Type* raw_ptr) noexcept {
+    // Конструктор из сырого указателя на память из size элементов,
+    // выделенную аллокатором alloc (например, полученного через Release()), либо nullptr
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr(Type* raw_ptr, size_t size, const Allocator& alloc = Allocator()) noexcept
+        : Holder(alloc) {
         raw_ptr_ = raw_ptr;
+        size_ = raw_ptr == nullptr ? 0 : size;
+        simple_vector_detail::RecordStats<Type>([this](auto& stats) {
+            stats.Track(size_ * sizeof(Type));
+        });
+    }
+
+    // Конструктор из чужой памяти на size элементов: при разрушении она освобождается
+    // не аллокатором, а deleter. Аллокатор alloc нужен лишь для создания и разрушения элементов
+    ArrayPtr(Type* raw_ptr, size_t size, std::unique_ptr<simple_vector_detail::BufferDeleter<Type>> deleter,
+             const Allocator& alloc = Allocator()) noexcept
+        : ArrayPtr(raw_ptr, size, alloc) {
+        if (raw_ptr_ != nullptr) {
+            deleter_ = deleter.release();
+        }
     }
 
     // Конструктор из временного объекта
-    ArrayPtr(ArrayPtr &&other) {
-        raw_ptr_ = other.raw_ptr_;
-        other.raw_ptr_ = nullptr;
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr(ArrayPtr &&other) noexcept
+        : Holder(other.GetAllocator()) {
+        raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        deleter_ = std::exchange(other.deleter_, nullptr);
     }
 
     // Запрещаем копирование
     ArrayPtr(const ArrayPtr&) = delete;
 
-    // Удаление массива при разрушении умного указателя
-    ~ArrayPtr() {
-        delete [] raw_ptr_;
+    // Освобождение памяти при разрушении умного указателя.
+    // Деструкторы элементов не вызываются: к этому моменту владелец должен их разрушить
+    SIMPLE_VECTOR_CONSTEXPR ~ArrayPtr() {
+        Deallocate();
     }
 
     // Запрещаем присваивание
     ArrayPtr& operator=(const ArrayPtr&) = delete;
 
-    // Перемещающий оператор присваивания
-    ArrayPtr& operator=(ArrayPtr&& rhs) {
+    // Перемещающий оператор присваивания.
+    // Аллокатор переходит вместе с памятью, только если он распространяется при перемещении,
+    // иначе аллокаторы обязаны быть равны
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr& operator=(ArrayPtr&& rhs) noexcept {
         if (this != &rhs) {
-            this->swap(rhs);
+            Deallocate();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                GetAllocator() = std::move(rhs.GetAllocator());
+            } else {
+                assert(GetAllocator() == rhs.GetAllocator());
+            }
+            raw_ptr_ = std::exchange(rhs.raw_ptr_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+            deleter_ = std::exchange(rhs.deleter_, nullptr);
         }
         return *this;
     }
 
     // Прекращает владением массивом в памяти, возвращает значение адреса массива
-    // После вызова метода указатель на массив должен обнулиться
-    [[nodiscard]] Type* Release() noexcept {
+    // После вызова метода указатель на массив должен обнулиться.
+    // У чужой памяти функция освобождения забывается без вызова: память возвращается хозяину
+    [[nodiscard]] SIMPLE_VECTOR_CONSTEXPR Type* Release() noexcept {
+        simple_vector_detail::RecordStats<Type>([this](auto& stats) {
+            stats.Untrack(size_ * sizeof(Type));
+        });
+        delete std::exchange(deleter_, nullptr);
         Type* temp_ptr_ = raw_ptr_;
         raw_ptr_ = nullptr;
+        size_ = 0;
         return temp_ptr_;
     }
 
+    // Сообщает, что память чужая и освобождается не аллокатором
+    SIMPLE_VECTOR_CONSTEXPR bool HasCustomDeleter() const noexcept {
+        return deleter_ != nullptr;
+    }
+
     // Возвращает ссылку на элемент массива с индексом index
-    Type& operator[](size_t index) noexcept {
+    SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept {
         return *(raw_ptr_ + index);
     }
 
     // Возвращает константную ссылку на элемент массива с индексом index
-    const Type& operator[](size_t index) const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept {
         return *(raw_ptr_ + index);
     }
 
     // Возвращает true, если указатель ненулевой, и false в противном случае
-    explicit operator bool() const {
+    SIMPLE_VECTOR_CONSTEXPR explicit operator bool() const {
         return raw_ptr_ != nullptr;
     }
 
     // Возвращает значение сырого указателя, хранящего адрес начала массива
-    Type* Get() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR Type* Get() const noexcept {
         return raw_ptr_;
     }
 
-    // Обменивается значениям указателя на массив с объектом other
-    void swap(ArrayPtr& other) noexcept {
+    // Возвращает количество элементов, под которые выделена память
+    SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Пытается увеличить выделенную память до new_size элементов без переноса.
+    // Возможно, только если аллокатор это поддерживает (например, ArenaAllocator)
+    SIMPLE_VECTOR_CONSTEXPR bool TryExpand(size_t new_size) noexcept {
+        if constexpr (simple_vector_detail::HasExpand<Allocator, Type>::value) {
+            if (raw_ptr_ != nullptr && deleter_ == nullptr && new_size > size_ && GetAllocator().Expand(raw_ptr_, size_, new_size)) {
+                simple_vector_detail::RecordStats<Type>([this, new_size](auto& stats) {
+                    stats.RecordExpansion(size_ * sizeof(Type), new_size * sizeof(Type));
+                });
+                size_ = new_size;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Возвращает аллокатор, которым выделена память
+    using Holder::GetAllocator;
+
+    // Обменивается значениям указателя на массив с объектом other.
+    // Аллокаторы обмениваются, только если они распространяются при обмене,
+    // иначе они обязаны быть равны
+    SIMPLE_VECTOR_CONSTEXPR void swap(ArrayPtr& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(GetAllocator(), other.GetAllocator());
+        } else {
+            assert(GetAllocator() == other.GetAllocator());
+        }
         std::swap(raw_ptr_, other.raw_ptr_);
+        std::swap(size_, other.size_);
+        std::swap(deleter_, other.deleter_);
     }
 
 private:
+    SIMPLE_VECTOR_CONSTEXPR void Deallocate() noexcept {
+        if (deleter_ != nullptr) {
+            deleter_->Delete(raw_ptr_, size_);
+            delete std::exchange(deleter_, nullptr);
+            simple_vector_detail::RecordStats<Type>([this](auto& stats) {
+                stats.Untrack(size_ * sizeof(Type));
+            });
+        } else if (raw_ptr_ != nullptr) {
+            AllocTraits::deallocate(GetAllocator(), raw_ptr_, size_);
+            simple_vector_detail::RecordStats<Type>([this](auto& stats) {
+                stats.RecordDeallocation(size_ * sizeof(Type));
+            });
+        }
+    }
+
     Type* raw_ptr_ = nullptr;
-};
\ No newline at end of file
+    size_t size_ = 0;
+    // Функция освобождения чужой памяти; nullptr — память выделена аллокатором
+    simple_vector_detail::BufferDeleter<Type>* deleter_ = nullptr;
+};
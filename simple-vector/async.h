@@ -0,0 +1,406 @@
+#pragma once
+
+#include "config.h"
+
+#if defined(SIMPLE_VECTOR_HAS_COROUTINES)
+
+#include <cassert>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "parallel.h"
+#include "simple_vector.h"
+
+// Заполнение SimpleVector из асинхронного источника (сокет, файл) пакетами на сопрограммах C++20:
+//     size_t count = co_await AppendFrom(v, source, 4096);
+// Пока текущий пакет декодируется прямо в хвост вектора, следующий уже читается.
+// Без поддержки сопрограмм (C++17) заголовок пуст
+
+template <typename T = void>
+class Task;
+
+namespace simple_vector_detail {
+
+// Общая часть обещания Task: сопрограмма стартует только при co_await, а по завершении
+// передаёт управление ожидающей сопрограмме без роста стека (симметричная передача)
+class TaskPromiseBase {
+public:
+    struct FinalAwaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            const std::coroutine_handle<> continuation = handle.promise().continuation_;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+
+    std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        error_ = std::current_exception();
+    }
+
+    void SetContinuation(std::coroutine_handle<> continuation) noexcept {
+        continuation_ = continuation;
+    }
+
+protected:
+    void RethrowIfFailed() const {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr error_;
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& value) {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    T TakeResult() {
+        RethrowIfFailed();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {
+    }
+
+    void TakeResult() const {
+        RethrowIfFailed();
+    }
+};
+
+} // namespace simple_vector_detail
+
+// Ленивая сопрограмма с результатом T: выполняется при co_await и возвращает результат
+// или пробрасывает исключение. Из обычного кода результат получают через SyncWait
+template <typename T>
+class Task {
+public:
+    using promise_type = simple_vector_detail::TaskPromise<T>;
+
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {
+    }
+
+    Task& operator=(Task&& rhs) noexcept {
+        if (this != &rhs) {
+            Destroy();
+            handle_ = std::exchange(rhs.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        Destroy();
+    }
+
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            bool await_ready() const noexcept {
+                return handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().SetContinuation(awaiting);
+                return handle;
+            }
+
+            T await_resume() {
+                return handle.promise().TakeResult();
+            }
+
+            std::coroutine_handle<promise_type> handle;
+        };
+        assert(handle_);
+        return Awaiter{handle_};
+    }
+
+private:
+    friend promise_type;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle) {
+    }
+
+    void Destroy() noexcept {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace simple_vector_detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+// Сопрограмма без ожидающего: стартует сразу и сама разрушается по завершении
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() const noexcept {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept {
+            return {};
+        }
+
+        void return_void() const noexcept {
+        }
+
+        void unhandled_exception() const noexcept {
+            std::terminate();
+        }
+    };
+};
+
+struct SyncWaitState {
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done = false;
+    std::exception_ptr error;
+};
+
+template <typename T, typename Result>
+DetachedTask RunAndNotify(Task<T>& task, std::optional<Result>& result, SyncWaitState& state) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+        } else {
+            result.emplace(co_await task);
+        }
+    } catch (...) {
+        state.error = std::current_exception();
+    }
+    // уведомление под мьютексом: SyncWait не разрушит состояние раньше времени
+    std::lock_guard lock(state.mutex);
+    state.done = true;
+    state.done_cv.notify_all();
+}
+
+// Состояние операции RunOnPool: результат и сопрограмма, ожидающая его
+template <typename T>
+struct PoolResultState {
+    std::mutex mutex;
+    std::optional<T> value;
+    std::exception_ptr error;
+    std::coroutine_handle<> continuation;
+    bool done = false;
+};
+
+template <typename Source, typename = void>
+struct HasSizeHint : std::false_type {};
+
+template <typename Source>
+struct HasSizeHint<Source, std::void_t<decltype(std::declval<const Source&>().SizeHint())>> : std::true_type {};
+
+} // namespace simple_vector_detail
+
+// Выполняет task в текущем потоке и ждёт её завершения, даже если она продолжается в других потоках.
+// Возвращает результат или пробрасывает исключение
+template <typename T>
+T SyncWait(Task<T> task) {
+    using Result = std::conditional_t<std::is_void_v<T>, bool, T>;
+    simple_vector_detail::SyncWaitState state;
+    std::optional<Result> result;
+    simple_vector_detail::RunAndNotify(task, result, state);
+    std::unique_lock lock(state.mutex);
+    state.done_cv.wait(lock, [&state] {
+        return state.done;
+    });
+    if (state.error) {
+        std::rethrow_exception(state.error);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*result);
+    }
+}
+
+// Результат RunOnPool: ожидание приостанавливает сопрограмму до завершения функции,
+// затем она продолжается в потоке пула, выполнившем функцию
+template <typename T>
+class PoolResult {
+public:
+    explicit PoolResult(std::shared_ptr<simple_vector_detail::PoolResultState<T>> state) noexcept
+        : state_(std::move(state)) {
+    }
+
+    bool await_ready() const {
+        std::lock_guard lock(state_->mutex);
+        return state_->done;
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+        std::lock_guard lock(state_->mutex);
+        if (state_->done) {
+            return false;
+        }
+        state_->continuation = awaiting;
+        return true;
+    }
+
+    T await_resume() {
+        std::lock_guard lock(state_->mutex);
+        if (state_->error) {
+            std::rethrow_exception(state_->error);
+        }
+        return std::move(*state_->value);
+    }
+
+private:
+    std::shared_ptr<simple_vector_detail::PoolResultState<T>> state_;
+};
+
+// Сразу ставит func в пул и возвращает ожидаемый результат. Подходит для источников
+// AppendFrom с блокирующим чтением: следующий пакет читается в потоке пула, пока текущий декодируется.
+// func должна быть копируемой и возвращать значение; пулу нужен хотя бы один поток
+template <typename Func>
+auto RunOnPool(ThreadPool& pool, Func func) -> PoolResult<std::invoke_result_t<Func&>> {
+    using T = std::invoke_result_t<Func&>;
+    static_assert(!std::is_void_v<T>, "RunOnPool needs a function returning a value");
+    auto state = std::make_shared<simple_vector_detail::PoolResultState<T>>();
+    pool.Submit([state, func = std::move(func)]() mutable {
+        std::exception_ptr error;
+        try {
+            T value = func();
+            std::lock_guard lock(state->mutex);
+            state->value.emplace(std::move(value));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::coroutine_handle<> continuation;
+        {
+            std::lock_guard lock(state->mutex);
+            state->error = error;
+            state->done = true;
+            continuation = std::exchange(state->continuation, nullptr);
+        }
+        if (continuation) {
+            continuation.resume();
+        }
+    });
+    return PoolResult<T>(std::move(state));
+}
+
+// Количество элементов в пакете AppendFrom по умолчанию
+inline constexpr size_t kDefaultAppendBatchSize = 4096;
+
+// Дописывает в конец v все элементы из source, пакетами не больше batch_size элементов.
+// Возвращает количество дописанных элементов. Источник предоставляет:
+//     Fetch(size_t max_count) — начинает чтение следующего пакета и возвращает ожидаемый объект
+//         (например, PoolResult из RunOnPool), дающий пакет; пустой пакет означает конец данных;
+//     size_t SizeHint() const — необязательно: сколько элементов ещё ожидается (0 — неизвестно).
+// Пакет предоставляет GetSize() и DecodeInto(Type* dest), записывающий GetSize() элементов.
+// Следующий Fetch вызывается до декодирования текущего пакета, так что чтение идёт параллельно
+// с декодированием, если Fetch действительно начинает работу сразу (ленивая Task начнёт её лишь при co_await).
+// Место под пакет выделяется через ResizeDefaultInit: тривиальные типы декодируются прямо
+// в неинициализированный хвост без промежуточного буфера, остальные — присваиванием
+// созданным по умолчанию элементам. По подсказке размера память резервируется один раз заранее.
+// Если DecodeInto выбросит исключение, недекодированный пакет удаляется из вектора,
+// а исключение пробрасывается после завершения уже начатого чтения
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Source>
+Task<size_t> AppendFrom(SimpleVector<Type, Allocator, GrowthPolicy>& v, Source& source,
+                        size_t batch_size = kDefaultAppendBatchSize) {
+    assert(batch_size > 0);
+    // резервирует место под extra полученных элементов и всё, что источник ещё обещает.
+    // Подсказка запрашивается до Fetch, пока чтение не идёт
+    auto reserve_ahead = [&v, &source](size_t extra) {
+        if constexpr (simple_vector_detail::HasSizeHint<Source>::value) {
+            const size_t needed = extra + source.SizeHint();
+            if (needed > v.GetCapacity() - v.GetSize()) {
+                v.Reserve(v.GetSize() + needed);
+            }
+        }
+    };
+    using Pending = decltype(source.Fetch(batch_size));
+    std::optional<Pending> pending;
+    reserve_ahead(0);
+    pending.emplace(source.Fetch(batch_size));
+    size_t appended = 0;
+    for (;;) {
+        auto batch = co_await std::move(*pending);
+        pending.reset();
+        const size_t count = batch.GetSize();
+        if (count == 0) {
+            break;
+        }
+        reserve_ahead(count);
+        // следующий пакет читается, пока текущий декодируется
+        pending.emplace(source.Fetch(batch_size));
+        const size_t old_size = v.GetSize();
+        std::exception_ptr error;
+        try {
+            v.ResizeDefaultInit(old_size + count);
+            batch.DecodeInto(v.begin() + old_size);
+        } catch (...) {
+            v.Resize(old_size);
+            error = std::current_exception();
+        }
+        if (error) {
+            // дожидаемся начатого чтения: оно ещё может обращаться к источнику
+            try {
+                co_await std::move(*pending);
+            } catch (...) {
+            }
+            std::rethrow_exception(error);
+        }
+        appended += count;
+    }
+    co_return appended;
+}
+
+#endif // SIMPLE_VECTOR_HAS_COROUTINES
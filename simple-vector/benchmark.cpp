@@ -0,0 +1,513 @@
+// Замеры производительности SimpleVector и его вариантов против std::vector.
+// Сборка: g++ -std=c++17 -O2 -DNDEBUG -pthread benchmark.cpp -o benchmark
+// Запуск: ./benchmark [фильтр] [--min-time=мс] [--repetitions=N] [--csv]
+// Фильтр — подстрока имени замера, например "PushBack" или "SimpleVector<string>"
+
+#include "simple_vector.h"
+#include "small_simple_vector.h"
+#include "soa_simple_vector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Не даёт компилятору выбросить вычисление value как неиспользуемое
+template <typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Состояние одного прогона: тело замера крутит цикл while (state.KeepRunning()).
+// Подготовку внутри итерации можно исключить из времени через PauseTiming/ResumeTiming
+class BenchmarkState {
+public:
+    using Clock = chrono::steady_clock;
+
+    explicit BenchmarkState(size_t iterations)
+        : iterations_(iterations), remaining_(iterations) {
+    }
+
+    bool KeepRunning() {
+        if (remaining_ == iterations_) {
+            start_ = Clock::now();
+        }
+        if (remaining_ == 0) {
+            elapsed_ += Clock::now() - start_;
+            return false;
+        }
+        --remaining_;
+        return true;
+    }
+
+    void PauseTiming() {
+        elapsed_ += Clock::now() - start_;
+    }
+
+    void ResumeTiming() {
+        start_ = Clock::now();
+    }
+
+    // Число элементов, обработанных за итерацию: отчёт покажет ещё и время на элемент
+    void SetItemsPerIteration(size_t items) {
+        items_ = items;
+    }
+
+    size_t GetIterations() const {
+        return iterations_;
+    }
+
+    size_t GetItemsPerIteration() const {
+        return items_;
+    }
+
+    chrono::nanoseconds GetElapsed() const {
+        return chrono::duration_cast<chrono::nanoseconds>(elapsed_);
+    }
+
+private:
+    size_t iterations_;
+    size_t remaining_;
+    size_t items_ = 0;
+    Clock::time_point start_;
+    Clock::duration elapsed_{};
+};
+
+struct Benchmark {
+    string name;
+    function<void(BenchmarkState&)> body;
+};
+
+struct BenchmarkOptions {
+    string_view filter;
+    chrono::milliseconds min_time{200};
+    size_t repetitions = 3;
+    bool csv = false;
+};
+
+struct BenchmarkResult {
+    size_t iterations = 0;
+    double ns_per_iteration = 0;
+    double ns_per_item = 0;
+};
+
+BenchmarkResult Measure(const Benchmark& benchmark, const BenchmarkOptions& options) {
+    // подбираем число итераций, пока прогон не займёт min_time
+    size_t iterations = 1;
+    for (;;) {
+        BenchmarkState state(iterations);
+        benchmark.body(state);
+        const auto elapsed = state.GetElapsed();
+        if (elapsed >= options.min_time || iterations >= (size_t{1} << 30)) {
+            break;
+        }
+        const double ratio = elapsed.count() > 0
+            ? static_cast<double>(chrono::nanoseconds(options.min_time).count()) / static_cast<double>(elapsed.count())
+            : 100.0;
+        iterations = static_cast<size_t>(static_cast<double>(iterations) * clamp(ratio * 1.2, 2.0, 100.0));
+    }
+
+    // повторяем с подобранным числом итераций и берём медиану
+    vector<BenchmarkResult> runs;
+    for (size_t i = 0; i < max<size_t>(options.repetitions, 1); ++i) {
+        BenchmarkState state(iterations);
+        benchmark.body(state);
+        BenchmarkResult run;
+        run.iterations = iterations;
+        run.ns_per_iteration = static_cast<double>(state.GetElapsed().count()) / static_cast<double>(iterations);
+        if (state.GetItemsPerIteration() > 0) {
+            run.ns_per_item = run.ns_per_iteration / static_cast<double>(state.GetItemsPerIteration());
+        }
+        runs.push_back(run);
+    }
+    nth_element(runs.begin(), runs.begin() + runs.size() / 2, runs.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.ns_per_iteration < rhs.ns_per_iteration;
+    });
+    return runs[runs.size() / 2];
+}
+
+void RunBenchmarks(const vector<Benchmark>& benchmarks, const BenchmarkOptions& options) {
+    if (options.csv) {
+        cout << "name,iterations,ns_per_iteration,ns_per_item" << endl;
+    } else {
+        cout << left << setw(52) << "Benchmark" << right << setw(16) << "ns/iter" << setw(12) << "ns/item"
+             << setw(12) << "iters" << endl;
+        cout << string(92, '-') << endl;
+    }
+    for (const Benchmark& benchmark : benchmarks) {
+        if (benchmark.name.find(options.filter) == string::npos) {
+            continue;
+        }
+        const BenchmarkResult result = Measure(benchmark, options);
+        if (options.csv) {
+            cout << benchmark.name << ',' << result.iterations << ',' << fixed << setprecision(2)
+                 << result.ns_per_iteration << ',' << result.ns_per_item << endl;
+        } else {
+            cout << left << setw(52) << benchmark.name << right << fixed << setprecision(1)
+                 << setw(16) << result.ns_per_iteration << setw(12) << setprecision(2) << result.ns_per_item
+                 << setw(12) << result.iterations << endl;
+        }
+    }
+}
+
+// Некопируемый тип из main.cpp
+class X {
+public:
+    X()
+        : X(5) {
+    }
+    X(size_t num)
+        : x_(num) {
+    }
+    X(const X& other) = delete;
+    X& operator=(const X& other) = delete;
+    X(X&& other) {
+        x_ = exchange(other.x_, 0);
+    }
+    X& operator=(X&& other) {
+        x_ = exchange(other.x_, 0);
+        return *this;
+    }
+    size_t GetX() const {
+        return x_;
+    }
+
+private:
+    size_t x_;
+};
+
+template <typename T>
+T MakeValue(size_t i);
+
+template <>
+int MakeValue<int>(size_t i) {
+    return static_cast<int>(i);
+}
+
+// строки длиннее буфера SSO, чтобы каждая владела памятью в куче
+template <>
+string MakeValue<string>(size_t i) {
+    string value = "benchmark-value-" + to_string(i);
+    value.resize(32, '.');
+    return value;
+}
+
+template <>
+X MakeValue<X>(size_t i) {
+    return X(i);
+}
+
+size_t Weight(int value) {
+    return static_cast<size_t>(value);
+}
+
+size_t Weight(const string& value) {
+    return value.size();
+}
+
+size_t Weight(const X& value) {
+    return value.GetX();
+}
+
+// Единый интерфейс к std::vector и векторам этого репозитория
+template <typename Container, typename T>
+void PushBack(Container& c, T&& value) {
+    c.PushBack(forward<T>(value));
+}
+
+template <typename Type, typename T>
+void PushBack(vector<Type>& c, T&& value) {
+    c.push_back(forward<T>(value));
+}
+
+template <typename Container>
+void ReserveFor(Container& c, size_t capacity) {
+    c.Reserve(capacity);
+}
+
+template <typename Type>
+void ReserveFor(vector<Type>& c, size_t capacity) {
+    c.reserve(capacity);
+}
+
+template <typename Container, typename T>
+void InsertAt(Container& c, size_t index, T&& value) {
+    c.Insert(c.begin() + index, forward<T>(value));
+}
+
+template <typename Type, typename T>
+void InsertAt(vector<Type>& c, size_t index, T&& value) {
+    c.insert(c.begin() + index, forward<T>(value));
+}
+
+template <typename Container>
+void EraseAt(Container& c, size_t index) {
+    c.Erase(c.begin() + index);
+}
+
+template <typename Type>
+void EraseAt(vector<Type>& c, size_t index) {
+    c.erase(c.begin() + index);
+}
+
+template <typename Container>
+size_t SizeOf(const Container& c) {
+    return c.GetSize();
+}
+
+template <typename Type>
+size_t SizeOf(const vector<Type>& c) {
+    return c.size();
+}
+
+inline constexpr size_t kGrowthSize = size_t{1} << 16;
+inline constexpr size_t kInsertSize = size_t{1} << 10;
+
+template <typename Container, typename T>
+Container MakeFilled(size_t size) {
+    Container c;
+    ReserveFor(c, size);
+    for (size_t i = 0; i < size; ++i) {
+        PushBack(c, MakeValue<T>(i));
+    }
+    return c;
+}
+
+enum class Position {
+    kFront,
+    kMiddle,
+    kBack,
+};
+
+size_t IndexFor(Position position, size_t size) {
+    switch (position) {
+    case Position::kFront:
+        return 0;
+    case Position::kMiddle:
+        return size / 2;
+    case Position::kBack:
+        break;
+    }
+    return size;
+}
+
+template <typename Container, typename T>
+void AddContainerBenchmarks(vector<Benchmark>& benchmarks, const string& container_name) {
+    benchmarks.push_back({container_name + "/PushBack", [](BenchmarkState& state) {
+        state.SetItemsPerIteration(kGrowthSize);
+        while (state.KeepRunning()) {
+            Container c;
+            for (size_t i = 0; i < kGrowthSize; ++i) {
+                PushBack(c, MakeValue<T>(i));
+            }
+            DoNotOptimize(c);
+        }
+    }});
+
+    benchmarks.push_back({container_name + "/Reserve+PushBack", [](BenchmarkState& state) {
+        state.SetItemsPerIteration(kGrowthSize);
+        while (state.KeepRunning()) {
+            Container c;
+            ReserveFor(c, kGrowthSize);
+            for (size_t i = 0; i < kGrowthSize; ++i) {
+                PushBack(c, MakeValue<T>(i));
+            }
+            DoNotOptimize(c);
+        }
+    }});
+
+    const pair<Position, string> positions[] = {
+        {Position::kFront, "front"},
+        {Position::kMiddle, "middle"},
+        {Position::kBack, "back"},
+    };
+    for (const auto& [position, position_name] : positions) {
+        benchmarks.push_back({container_name + "/Insert/" + position_name, [position = position](BenchmarkState& state) {
+            state.SetItemsPerIteration(kInsertSize);
+            Container c;
+            while (state.KeepRunning()) {
+                for (size_t i = 0; i < kInsertSize; ++i) {
+                    InsertAt(c, IndexFor(position, SizeOf(c)), MakeValue<T>(i));
+                }
+                DoNotOptimize(c);
+                state.PauseTiming();
+                c = Container();
+                state.ResumeTiming();
+            }
+        }});
+
+        benchmarks.push_back({container_name + "/Erase/" + position_name, [position = position](BenchmarkState& state) {
+            state.SetItemsPerIteration(kInsertSize);
+            while (state.KeepRunning()) {
+                state.PauseTiming();
+                Container c = MakeFilled<Container, T>(kInsertSize);
+                state.ResumeTiming();
+                while (SizeOf(c) > 0) {
+                    const size_t index = IndexFor(position, SizeOf(c));
+                    EraseAt(c, index == SizeOf(c) ? index - 1 : index);
+                }
+                DoNotOptimize(c);
+            }
+        }});
+    }
+
+    if constexpr (is_copy_constructible_v<T>) {
+        benchmarks.push_back({container_name + "/Copy", [](BenchmarkState& state) {
+            const Container source = MakeFilled<Container, T>(kGrowthSize);
+            state.SetItemsPerIteration(kGrowthSize);
+            while (state.KeepRunning()) {
+                Container copy(source);
+                DoNotOptimize(copy);
+            }
+        }});
+    }
+
+    benchmarks.push_back({container_name + "/Move", [](BenchmarkState& state) {
+        Container source = MakeFilled<Container, T>(kGrowthSize);
+        while (state.KeepRunning()) {
+            Container moved(std::move(source));
+            DoNotOptimize(moved);
+            source = std::move(moved);
+        }
+    }});
+
+    if constexpr (is_copy_constructible_v<T>) {
+        benchmarks.push_back({container_name + "/Equal", [](BenchmarkState& state) {
+            const Container lhs = MakeFilled<Container, T>(kGrowthSize);
+            const Container rhs = lhs;
+            state.SetItemsPerIteration(kGrowthSize);
+            while (state.KeepRunning()) {
+                DoNotOptimize(lhs == rhs);
+            }
+        }});
+
+        benchmarks.push_back({container_name + "/Less", [](BenchmarkState& state) {
+            const Container lhs = MakeFilled<Container, T>(kGrowthSize);
+            const Container rhs = lhs;
+            state.SetItemsPerIteration(kGrowthSize);
+            while (state.KeepRunning()) {
+                DoNotOptimize(lhs < rhs);
+            }
+        }});
+    }
+
+    benchmarks.push_back({container_name + "/Iterate", [](BenchmarkState& state) {
+        const Container c = MakeFilled<Container, T>(kGrowthSize);
+        state.SetItemsPerIteration(kGrowthSize);
+        while (state.KeepRunning()) {
+            size_t total = 0;
+            for (const auto& value : c) {
+                total += Weight(value);
+            }
+            DoNotOptimize(total);
+        }
+    }});
+}
+
+template <typename T>
+void AddElementBenchmarks(vector<Benchmark>& benchmarks, const string& type_name) {
+    AddContainerBenchmarks<vector<T>, T>(benchmarks, "std::vector<" + type_name + ">");
+    AddContainerBenchmarks<SimpleVector<T>, T>(benchmarks, "SimpleVector<" + type_name + ">");
+    AddContainerBenchmarks<SmallSimpleVector<T, 16>, T>(benchmarks, "SmallSimpleVector<" + type_name + ", 16>");
+}
+
+// Строки из трёх полей: массив структур против структуры массивов
+using Row = tuple<int, double, string>;
+
+void AddLayoutBenchmarks(vector<Benchmark>& benchmarks) {
+    benchmarks.push_back({"std::vector<Row>/PushBack", [](BenchmarkState& state) {
+        state.SetItemsPerIteration(kGrowthSize);
+        while (state.KeepRunning()) {
+            vector<Row> rows;
+            for (size_t i = 0; i < kGrowthSize; ++i) {
+                rows.emplace_back(static_cast<int>(i), static_cast<double>(i), MakeValue<string>(i));
+            }
+            DoNotOptimize(rows);
+        }
+    }});
+
+    benchmarks.push_back({"SoASimpleVector<Row>/PushBack", [](BenchmarkState& state) {
+        state.SetItemsPerIteration(kGrowthSize);
+        while (state.KeepRunning()) {
+            SoASimpleVector<int, double, string> rows;
+            for (size_t i = 0; i < kGrowthSize; ++i) {
+                rows.EmplaceBack(static_cast<int>(i), static_cast<double>(i), MakeValue<string>(i));
+            }
+            DoNotOptimize(rows);
+        }
+    }});
+
+    benchmarks.push_back({"std::vector<Row>/SumField", [](BenchmarkState& state) {
+        vector<Row> rows;
+        for (size_t i = 0; i < kGrowthSize; ++i) {
+            rows.emplace_back(static_cast<int>(i), static_cast<double>(i), MakeValue<string>(i));
+        }
+        state.SetItemsPerIteration(kGrowthSize);
+        while (state.KeepRunning()) {
+            double total = 0;
+            for (const Row& row : rows) {
+                total += get<1>(row);
+            }
+            DoNotOptimize(total);
+        }
+    }});
+
+    benchmarks.push_back({"SoASimpleVector<Row>/SumField", [](BenchmarkState& state) {
+        SoASimpleVector<int, double, string> rows;
+        for (size_t i = 0; i < kGrowthSize; ++i) {
+            rows.EmplaceBack(static_cast<int>(i), static_cast<double>(i), MakeValue<string>(i));
+        }
+        state.SetItemsPerIteration(kGrowthSize);
+        while (state.KeepRunning()) {
+            const auto column = rows.Column<1>();
+            DoNotOptimize(accumulate(column.begin(), column.end(), 0.0));
+        }
+    }});
+}
+
+BenchmarkOptions ParseOptions(int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if (arg.substr(0, 11) == "--min-time=") {
+            options.min_time = chrono::milliseconds(stoll(string(arg.substr(11))));
+        } else if (arg.substr(0, 14) == "--repetitions=") {
+            options.repetitions = stoull(string(arg.substr(14)));
+        } else if (arg == "--csv") {
+            options.csv = true;
+        } else {
+            options.filter = arg;
+        }
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const BenchmarkOptions options = ParseOptions(argc, argv);
+    vector<Benchmark> benchmarks;
+    AddElementBenchmarks<int>(benchmarks, "int");
+    AddElementBenchmarks<string>(benchmarks, "string");
+    AddElementBenchmarks<X>(benchmarks, "X");
+    AddLayoutBenchmarks(benchmarks);
+    RunBenchmarks(benchmarks, options);
+    return 0;
+}
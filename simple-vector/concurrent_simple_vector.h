@@ -0,0 +1,496 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simple_vector.h"
+#include "uninitialized.h"
+
+// Вектор для одновременного добавления из многих потоков без блокировок.
+// Память состоит из корзин, размеры которых растут вдвое: корзина k вмещает
+// kFirstBucketSize * 2^k элементов. Рост лишь добавляет корзины, поэтому элементы
+// никогда не переносятся, а ссылки и указатели на них остаются действительными.
+// Место под элементы резервируется одним fetch_add, корзину выделяет первый
+// понадобившийся ей поток (при гонке лишняя корзина освобождается).
+//
+// PushBack, EmplaceBack, GrowBy, GetSize и доступ к уже добавленным элементам можно
+// вызывать одновременно. GetSize учитывает и элементы, которые ещё создаются: читать
+// чужие элементы можно после синхронизации с их производителем (например, join).
+// Clear, ToSimpleVector и разрушение требуют, чтобы другие потоки вектор не трогали.
+// Аллокатор должен быть потокобезопасным.
+//
+// Выданный индекс нельзя вернуть. Если создание элемента (или выделение его корзины) бросило
+// исключение, оставшиеся ячейки заполняются Type(); если и это невозможно, они запоминаются
+// как пустые: ForEachSegment, ToSimpleVector, Clear и деструктор их пропускают, а читать их
+// через operator[] и итераторы нельзя (HasHoles сообщает, есть ли такие ячейки)
+template <typename Type, typename Allocator = std::allocator<Type>>
+class ConcurrentSimpleVector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static constexpr size_t kFirstBucketShift = 4;
+    static constexpr size_t kBucketCount = std::numeric_limits<size_t>::digits - kFirstBucketShift;
+
+    // Итератор произвольного доступа по индексу; помнит границу текущей корзины,
+    // чтобы последовательный обход не вычислял корзину на каждом шаге
+    template <typename Owner, typename Value>
+    class BasicIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_const_t<Value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        BasicIterator() = default;
+
+        reference operator*() const noexcept {
+            return *Slot();
+        }
+
+        pointer operator->() const noexcept {
+            return Slot();
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            if (slot_ != nullptr && ++slot_ == bucket_end_) {
+                slot_ = nullptr;
+            }
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            slot_ = nullptr;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator copy = *this;
+            --*this;
+            return copy;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += static_cast<size_t>(offset);
+            slot_ = nullptr;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            return *this += -offset;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_ - rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        // Итератор изменяемых элементов приводится к константному
+        template <typename OtherOwner, typename OtherValue,
+                  typename = std::enable_if_t<std::is_convertible_v<OtherValue*, Value*>>>
+        BasicIterator(const BasicIterator<OtherOwner, OtherValue>& other) noexcept
+            : owner_(other.owner_), index_(other.index_) {
+        }
+
+    private:
+        template <typename, typename>
+        friend class BasicIterator;
+        friend class ConcurrentSimpleVector;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner), index_(index) {
+        }
+
+        pointer Slot() const noexcept {
+            if (slot_ == nullptr) {
+                const auto [bucket, offset] = Locate(index_);
+                Type* data = owner_->buckets_[bucket].load(std::memory_order_acquire);
+                slot_ = data + offset;
+                bucket_end_ = data + BucketSize(bucket);
+            }
+            return slot_;
+        }
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+        mutable Type* slot_ = nullptr;
+        mutable Type* bucket_end_ = nullptr;
+    };
+
+public:
+    static constexpr size_t kFirstBucketSize = size_t{1} << kFirstBucketShift;
+
+    using Iterator = BasicIterator<ConcurrentSimpleVector, Type>;
+    using ConstIterator = BasicIterator<const ConcurrentSimpleVector, const Type>;
+    using allocator_type = Allocator;
+
+    ConcurrentSimpleVector() = default;
+
+    explicit ConcurrentSimpleVector(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    ConcurrentSimpleVector(const ConcurrentSimpleVector&) = delete;
+    ConcurrentSimpleVector& operator=(const ConcurrentSimpleVector&) = delete;
+
+    ~ConcurrentSimpleVector() {
+        Clear();
+        for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+            if (Type* data = buckets_[bucket].load(std::memory_order_relaxed)) {
+                AllocTraits::deallocate(alloc_, data, BucketSize(bucket));
+            }
+        }
+    }
+
+    // Добавляет элемент и возвращает ссылку на него
+    Type& PushBack(const Type& item) {
+        return EmplaceBack(item);
+    }
+
+    Type& PushBack(Type&& item) {
+        return EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент из args в зарезервированной ячейке и возвращает ссылку на него
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        const size_t index = ReserveRange(1);
+        try {
+            Type* slot = SlotAt(index);
+            simple_vector_detail::ConstructAt(alloc_, slot, std::forward<Args>(args)...);
+            return *slot;
+        } catch (...) {
+            FillHoles(index, index + 1);
+            throw;
+        }
+    }
+
+    // Добавляет count копий value одним резервированием. Новые элементы идут подряд по индексам.
+    // Возвращает итератор на первый из них
+    Iterator GrowBy(size_t count, const Type& value = Type()) {
+        const size_t first = ReserveRange(count);
+        size_t built = first;
+        try {
+            ForEachSlotRange(first, first + count, [this, &value, &built](Type* slots, size_t slot_count) {
+                for (size_t i = 0; i < slot_count; ++i) {
+                    simple_vector_detail::ConstructAt(alloc_, slots + i, value);
+                    ++built;
+                }
+            });
+        } catch (...) {
+            FillHoles(built, first + count);
+            throw;
+        }
+        return Iterator(this, first);
+    }
+
+    // Возвращает количество зарезервированных элементов
+    size_t GetSize() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Сообщает, пустой ли вектор
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Сообщает, есть ли ячейки без объектов, оставшиеся после исключений при создании
+    bool HasHoles() const noexcept {
+        return has_holes_.load(std::memory_order_acquire);
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < GetSize());
+        return *LocateSlot(index);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return *LocateSlot(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("out of range");
+        }
+        return *LocateSlot(index);
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("out of range");
+        }
+        return *LocateSlot(index);
+    }
+
+    // Вызывает func(first, count) для каждого непрерывного участка элементов по порядку.
+    // Пустые ячейки пропускаются
+    template <typename Func>
+    void ForEachSegment(Func func) {
+        const size_t size = GetSize();
+        if (!HasHoles()) {
+            ForEachSlotRange(0, size, func);
+            return;
+        }
+        SimpleVector<Hole> holes;
+        {
+            std::lock_guard lock(holes_mutex_);
+            holes = holes_;
+        }
+        std::sort(holes.begin(), holes.end());
+        ForEachBuiltRange(size, holes, func);
+    }
+
+    template <typename Func>
+    void ForEachSegment(Func func) const {
+        const_cast<ConcurrentSimpleVector*>(this)->ForEachSegment([&func](Type* first, size_t count) {
+            func(static_cast<const Type*>(first), count);
+        });
+    }
+
+    // Разрушает элементы; корзины остаются выделенными для повторного использования
+    void Clear() noexcept {
+        const size_t size = size_.load(std::memory_order_relaxed);
+        auto destroy = [this](Type* first, size_t count) noexcept {
+            simple_vector_detail::DestroyRange(alloc_, first, first + count);
+        };
+        if (HasHoles()) {
+            std::sort(holes_.begin(), holes_.end());
+            ForEachBuiltRange(size, holes_, destroy);
+            holes_.Clear();
+            has_holes_.store(false, std::memory_order_relaxed);
+        } else {
+            ForEachSlotRange(0, size, destroy);
+        }
+        size_.store(0, std::memory_order_relaxed);
+    }
+
+    // Переносит элементы в обычный SimpleVector и очищает себя. Пустые ячейки не переносятся.
+    // Без копирования не обойтись: SimpleVector требует непрерывной памяти, а корзины разрознены.
+    // Тривиально копируемые элементы переносятся memcpy по корзинам
+    template <typename GrowthPolicy = DoublingGrowth>
+    SimpleVector<Type, Allocator, GrowthPolicy> ToSimpleVector() {
+        SimpleVector<Type, Allocator, GrowthPolicy> result(alloc_);
+        result.Reserve(GetSize());
+        ForEachSegment([&result](Type* first, size_t count) {
+            result.Append(std::make_move_iterator(first), std::make_move_iterator(first + count));
+        });
+        Clear();
+        return result;
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, GetSize());
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, GetSize());
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Участок индексов [first, last), в котором объекты не созданы
+    using Hole = std::pair<size_t, size_t>;
+
+    static constexpr size_t BucketSize(size_t bucket) noexcept {
+        return kFirstBucketSize << bucket;
+    }
+
+    // Номер корзины и смещение в ней для элемента index
+    static std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t shifted = index + kFirstBucketSize;
+        size_t high_bit = 0;
+#if defined(__GNUC__)
+        high_bit = static_cast<size_t>(std::numeric_limits<unsigned long long>::digits - 1 - __builtin_clzll(shifted));
+#else
+        for (size_t value = shifted; value > 1; value >>= 1) {
+            ++high_bit;
+        }
+#endif
+        const size_t bucket = high_bit - kFirstBucketShift;
+        return {bucket, shifted - BucketSize(bucket)};
+    }
+
+    // Индекс первого элемента корзины
+    static constexpr size_t BucketStart(size_t bucket) noexcept {
+        return BucketSize(bucket) - kFirstBucketSize;
+    }
+
+    size_t ReserveRange(size_t count) {
+        constexpr size_t max_size = std::numeric_limits<size_t>::max() - kFirstBucketSize;
+        const size_t first = size_.fetch_add(count, std::memory_order_acq_rel);
+        if (first > max_size - count) {
+            size_.fetch_sub(count, std::memory_order_relaxed);
+            throw std::length_error("ConcurrentSimpleVector is too long");
+        }
+        return first;
+    }
+
+    Type* LocateSlot(size_t index) const noexcept {
+        const auto [bucket, offset] = Locate(index);
+        return buckets_[bucket].load(std::memory_order_acquire) + offset;
+    }
+
+    // Указатель на ячейку index; при необходимости выделяет её корзину
+    Type* SlotAt(size_t index) {
+        const auto [bucket, offset] = Locate(index);
+        return EnsureBucket(bucket) + offset;
+    }
+
+    Type* EnsureBucket(size_t bucket) {
+        Type* data = buckets_[bucket].load(std::memory_order_acquire);
+        if (data != nullptr) {
+            return data;
+        }
+        Type* fresh = AllocTraits::allocate(alloc_, BucketSize(bucket));
+        if (buckets_[bucket].compare_exchange_strong(data, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return fresh;
+        }
+        // корзину уже выделил другой поток
+        AllocTraits::deallocate(alloc_, fresh, BucketSize(bucket));
+        return data;
+    }
+
+    // Вызывает func(first, count) для участков ячеек [first_index, last_index) внутри корзин
+    template <typename Func>
+    void ForEachSlotRange(size_t first_index, size_t last_index, Func& func) {
+        while (first_index < last_index) {
+            const auto [bucket, offset] = Locate(first_index);
+            const size_t count = std::min(BucketSize(bucket) - offset, last_index - first_index);
+            func(EnsureBucket(bucket) + offset, count);
+            first_index += count;
+        }
+    }
+
+    template <typename Func>
+    void ForEachSlotRange(size_t first_index, size_t last_index, Func&& func) {
+        ForEachSlotRange(first_index, last_index, func);
+    }
+
+    // Вызывает func для участков [0, last_index) вне пустых ячеек holes (отсортированных).
+    // Корзины этих участков уже выделены, поэтому EnsureBucket здесь не выделяет память
+    template <typename Func>
+    void ForEachBuiltRange(size_t last_index, const SimpleVector<Hole>& holes, Func& func) {
+        size_t index = 0;
+        for (const auto& [hole_first, hole_last] : holes) {
+            if (hole_first >= last_index) {
+                break;
+            }
+            ForEachSlotRange(index, hole_first, func);
+            index = hole_last;
+        }
+        ForEachSlotRange(index, last_index, func);
+    }
+
+    // Индексы [first, last) уже выданы и не могут быть возвращены, а объекты в них не созданы.
+    // Ячейки по возможности заполняются значением по умолчанию, чтобы вектор оставался целым;
+    // не заполненные (нет конструктора по умолчанию, он бросил исключение или не выделилась
+    // корзина) запоминаются как пустые
+    void FillHoles(size_t first, size_t last) noexcept {
+        if constexpr (std::is_default_constructible_v<Type>) {
+            try {
+                ForEachSlotRange(first, last, [this, &first](Type* slots, size_t count) {
+                    for (size_t i = 0; i < count; ++i) {
+                        simple_vector_detail::ConstructAt(alloc_, slots + i);
+                        ++first;
+                    }
+                });
+                return;
+            } catch (...) {
+            }
+        }
+        // память под запись нужна только на редком пути ошибки; если её нет, продолжать нельзя
+        std::lock_guard lock(holes_mutex_);
+        holes_.PushBack(Hole(first, last));
+        has_holes_.store(true, std::memory_order_release);
+    }
+
+    Allocator alloc_;
+    std::atomic<size_t> size_ = 0;
+    std::atomic<Type*> buckets_[kBucketCount] = {};
+    std::atomic<bool> has_holes_ = false;
+    std::mutex holes_mutex_;
+    SimpleVector<Hole> holes_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <type_traits>
+#if __has_include(<version>)
+#include <version>
+#endif
+
+// SIMPLE_VECTOR_CONSTEXPR помечает функции, которые можно вызывать при вычислении константных
+// выражений. Это возможно начиная с C++20, где std::allocator выделяет память и в constexpr:
+//     constexpr auto kTable = [] { SimpleVector<int> v; ...; return v.GetSize(); }();
+// В C++17 макрос пуст. Память, выделенную при вычислении, нужно освободить до его конца:
+// вектор не может быть constexpr-переменной, но из него можно получить размер, сумму или std::array
+#if defined(__cpp_lib_constexpr_dynamic_alloc) && __cpp_lib_constexpr_dynamic_alloc >= 201907L \
+    && defined(__cpp_lib_is_constant_evaluated)
+#define SIMPLE_VECTOR_HAS_CONSTEXPR 1
+#define SIMPLE_VECTOR_CONSTEXPR constexpr
+#else
+#define SIMPLE_VECTOR_CONSTEXPR
+#endif
+
+// SIMPLE_VECTOR_HAS_COROUTINES: компилятор и стандартная библиотека поддерживают сопрограммы C++20.
+// Без них async.h пуст
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine)
+#define SIMPLE_VECTOR_HAS_COROUTINES 1
+#endif
+
+namespace simple_vector_detail {
+
+// true во время вычисления константного выражения: там недоступны memcpy, векторные
+// инструкции и атомарные счётчики, и код переходит на поэлементные циклы
+constexpr bool IsConstantEvaluated() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+} // namespace simple_vector_detail
@@ -0,0 +1,528 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "simple_vector.h"
+#include "simple_vector_view.h"
+
+namespace simple_vector_detail {
+
+inline size_t TrailingZeros(size_t value) noexcept {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_ctzll(value));
+#else
+    size_t count = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+} // namespace simple_vector_detail
+
+// Стратегии поиска в отсортированных ключах FlatSet и FlatMap. Index хранит дополнительную
+// раскладку ключей (если она нужна), Rebuild вызывается после каждого изменения ключей,
+// LowerBound возвращает позицию первого ключа не меньше key в отсортированном массиве.
+
+// Двоичный поиск без ветвлений (Khuong, Morin. Array layouts for comparison-based searching):
+// выбор половины компилируется в условную пересылку, так что нет ошибок предсказания переходов.
+// Дополнительной памяти не требует
+struct BranchlessSearch {
+    template <typename Key, typename Compare>
+    class Index {
+    public:
+        void Rebuild(const Key* /*keys*/, size_t /*size*/) {
+        }
+
+        size_t LowerBound(const Key* keys, size_t size, const Key& key, const Compare& comp) const {
+            if (size == 0) {
+                return 0;
+            }
+            const Key* base = keys;
+            while (size > 1) {
+                const size_t half = size / 2;
+                base = comp(base[half], key) ? base + half : base;
+                size -= half;
+            }
+            return static_cast<size_t>(base - keys) + (comp(*base, key) ? 1 : 0);
+        }
+    };
+};
+
+// Поиск по копии ключей в раскладке Эйтцингера (дерево поиска в порядке обхода в ширину):
+// первые уровни дерева делят несколько строк кэша, следующие уровни легко предсказываются.
+// Быстрее двоичного поиска на больших таблицах, но хранит копию ключей с их позициями
+// и перестраивает её за O(n) после каждого изменения — подходит таблицам, которые
+// строятся целиком (BuildFrom, InsertSorted) и затем в основном читаются
+struct EytzingerSearch {
+    template <typename Key, typename Compare>
+    class Index {
+    public:
+        void Rebuild(const Key* keys, size_t size) {
+            tree_.Clear();
+            positions_.Clear();
+            if (size == 0) {
+                return;
+            }
+            // нулевой элемент не используется: потомки узла k — 2k и 2k + 1
+            tree_.Resize(size + 1);
+            positions_.Resize(size + 1);
+            size_t next = 0;
+            Fill(keys, size, 1, next);
+        }
+
+        size_t LowerBound(const Key* /*keys*/, size_t size, const Key& key, const Compare& comp) const {
+            assert(tree_.IsEmpty() || tree_.GetSize() == size + 1);
+            size_t k = 1;
+            while (k <= size) {
+                k = 2 * k + (comp(tree_[k], key) ? 1 : 0);
+            }
+            // отбрасываем спуски вправо после последнего спуска влево
+            k >>= simple_vector_detail::TrailingZeros(~k) + 1;
+            return k == 0 ? size : positions_[k];
+        }
+
+    private:
+        // Обходит дерево в симметричном порядке, раскладывая по нему отсортированные ключи
+        void Fill(const Key* keys, size_t size, size_t k, size_t& next) {
+            if (k > size) {
+                return;
+            }
+            Fill(keys, size, 2 * k, next);
+            tree_[k] = keys[next];
+            positions_[k] = next++;
+            Fill(keys, size, 2 * k + 1, next);
+        }
+
+        SimpleVector<Key> tree_;
+        SimpleVector<size_t> positions_;
+    };
+};
+
+// Множество в отсортированном SimpleVector: ключи лежат подряд, поиск не ходит по узлам.
+// Вставка и удаление одного ключа сдвигают хвост (O(n)), поэтому большие наборы лучше
+// добавлять целиком через BuildFrom или InsertSorted, которые сортируют и удаляют повторы один раз.
+// Итераторы, указатели и ссылки на ключи становятся недействительными при любом изменении
+template <typename Key, typename Compare = std::less<Key>, typename SearchPolicy = BranchlessSearch>
+class FlatSet {
+    using Index = typename SearchPolicy::template Index<Key, Compare>;
+
+public:
+    using ConstIterator = const Key*;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    FlatSet(std::initializer_list<Key> init, const Compare& comp = Compare())
+        : comp_(comp) {
+        BuildFrom(init.begin(), init.end());
+    }
+
+    // Заменяет содержимое ключами из [first, last) в любом порядке: они сортируются один раз,
+    // из равных остаётся первый
+    template <typename InputIt>
+    void BuildFrom(InputIt first, InputIt last) {
+        SimpleVector<Key> keys;
+        keys.Assign(first, last);
+        std::stable_sort(keys.begin(), keys.end(), comp_);
+        keys.Erase(std::unique(keys.begin(), keys.end(), Equivalent()), keys.end());
+        keys_.swap(keys);
+        index_.Rebuild(keys_.cbegin(), keys_.GetSize());
+    }
+
+    // Добавляет отсортированные ключи [first, last): они дописываются в конец и сливаются
+    // с имеющимися за один проход. Повторы и уже имеющиеся ключи отбрасываются
+    template <typename InputIt>
+    void InsertSorted(InputIt first, InputIt last) {
+        const size_t old_size = keys_.GetSize();
+        keys_.Append(first, last);
+        auto middle = keys_.begin() + old_size;
+        assert(std::is_sorted(middle, keys_.end(), comp_));
+        std::inplace_merge(keys_.begin(), middle, keys_.end(), comp_);
+        // слияние устойчиво: из равных ключей первым идёт уже имевшийся
+        keys_.Erase(std::unique(keys_.begin(), keys_.end(), Equivalent()), keys_.end());
+        index_.Rebuild(keys_.cbegin(), keys_.GetSize());
+    }
+
+    // Вставляет key. Возвращает итератор на ключ и признак того, что его не было
+    std::pair<ConstIterator, bool> Insert(const Key& key) {
+        const size_t pos = Position(key);
+        if (pos < keys_.GetSize() && !comp_(key, keys_[pos])) {
+            return {keys_.cbegin() + pos, false};
+        }
+        keys_.Insert(keys_.cbegin() + pos, key);
+        index_.Rebuild(keys_.cbegin(), keys_.GetSize());
+        return {keys_.cbegin() + pos, true};
+    }
+
+    // Удаляет key. Возвращает количество удалённых ключей (0 или 1)
+    size_t Erase(const Key& key) {
+        const ConstIterator it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        Erase(it);
+        return 1;
+    }
+
+    ConstIterator Erase(ConstIterator pos) {
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет ключи [first, last) одним сдвигом хвоста
+    ConstIterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t index = static_cast<size_t>(first - keys_.cbegin());
+        keys_.Erase(first, last);
+        index_.Rebuild(keys_.cbegin(), keys_.GetSize());
+        return keys_.cbegin() + index;
+    }
+
+    // Возвращает итератор на key либо end()
+    ConstIterator Find(const Key& key) const {
+        const size_t pos = Position(key);
+        if (pos < keys_.GetSize() && !comp_(key, keys_[pos])) {
+            return keys_.cbegin() + pos;
+        }
+        return end();
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != end();
+    }
+
+    size_t Count(const Key& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Возвращает итератор на первый ключ не меньше key
+    ConstIterator LowerBound(const Key& key) const {
+        return keys_.cbegin() + Position(key);
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        index_.Rebuild(keys_.cbegin(), 0);
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    // Отсортированные ключи как непрерывный массив
+    ConstSimpleVectorView<Key> Keys() const noexcept {
+        return keys_;
+    }
+
+    void swap(FlatSet& other) noexcept {
+        keys_.swap(other.keys_);
+        std::swap(comp_, other.comp_);
+        std::swap(index_, other.index_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return keys_.cbegin();
+    }
+
+    ConstIterator end() const noexcept {
+        return keys_.cend();
+    }
+
+    friend bool operator==(const FlatSet& lhs, const FlatSet& rhs) {
+        return lhs.keys_ == rhs.keys_;
+    }
+
+    friend bool operator!=(const FlatSet& lhs, const FlatSet& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    auto Equivalent() const {
+        return [this](const Key& lhs, const Key& rhs) {
+            return !comp_(lhs, rhs) && !comp_(rhs, lhs);
+        };
+    }
+
+    size_t Position(const Key& key) const {
+        return index_.LowerBound(keys_.cbegin(), keys_.GetSize(), key, comp_);
+    }
+
+    SimpleVector<Key> keys_;
+    Compare comp_;
+    Index index_;
+};
+
+// Отображение в двух параллельных отсортированных столбцах (структура массивов): поиск
+// читает только столбец ключей, значения нужны лишь для найденной позиции.
+// Позиция i обоих столбцов — одна пара. Правила вставки и недействительности
+// ссылок те же, что у FlatSet
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename SearchPolicy = BranchlessSearch>
+class FlatMap {
+    using Index = typename SearchPolicy::template Index<Key, Compare>;
+
+public:
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    FlatMap(std::initializer_list<std::pair<Key, Value>> init, const Compare& comp = Compare())
+        : comp_(comp) {
+        BuildFrom(init.begin(), init.end());
+    }
+
+    // Заменяет содержимое парами (ключ, значение) из [first, last) в любом порядке:
+    // они сортируются один раз, из пар с равными ключами остаётся первая
+    template <typename InputIt>
+    void BuildFrom(InputIt first, InputIt last) {
+        SimpleVector<std::pair<Key, Value>> pairs;
+        pairs.Assign(first, last);
+        std::stable_sort(pairs.begin(), pairs.end(), [this](const auto& lhs, const auto& rhs) {
+            return comp_(lhs.first, rhs.first);
+        });
+        SimpleVector<Key> keys(::Reserve(pairs.GetSize()));
+        SimpleVector<Value> values(::Reserve(pairs.GetSize()));
+        for (auto& [key, value] : pairs) {
+            if (keys.IsEmpty() || comp_(keys[keys.GetSize() - 1], key)) {
+                keys.PushBack(std::move(key));
+                values.PushBack(std::move(value));
+            }
+        }
+        Replace(std::move(keys), std::move(values));
+    }
+
+    // Добавляет пары [first, last), отсортированные по ключу, слиянием с имеющимися за один проход.
+    // Пары с повторными или уже имеющимися ключами отбрасываются. Если копирование выбросит
+    // исключение, содержимое не меняется
+    template <typename InputIt>
+    void InsertSorted(InputIt first, InputIt last) {
+        // сначала новые пары копируются во временные столбцы: имеющиеся ещё не тронуты
+        SimpleVector<Key> added_keys;
+        SimpleVector<Value> added_values;
+        if constexpr (simple_vector_detail::IsForwardIterator<InputIt>::value) {
+            added_keys.Reserve(static_cast<size_t>(std::distance(first, last)));
+            added_values.Reserve(added_keys.GetCapacity());
+        }
+        size_t pos = 0;
+        for (; first != last; ++first) {
+            const auto& [key, value] = *first;
+            assert(added_keys.IsEmpty() || !comp_(key, added_keys[added_keys.GetSize() - 1]));
+            while (pos < keys_.GetSize() && comp_(keys_[pos], key)) {
+                ++pos;
+            }
+            const bool present = pos < keys_.GetSize() && !comp_(key, keys_[pos]);
+            const bool repeated = !added_keys.IsEmpty() && !comp_(added_keys[added_keys.GetSize() - 1], key);
+            if (!present && !repeated) {
+                added_keys.PushBack(key);
+                added_values.PushBack(value);
+            }
+        }
+        if (added_keys.IsEmpty()) {
+            return;
+        }
+        // затем слияние: имеющиеся элементы перемещаются, только если перемещение не бросает,
+        // иначе копируются, так что при исключении keys_ и values_ остаются целыми
+        const size_t total = keys_.GetSize() + added_keys.GetSize();
+        SimpleVector<Key> keys(::Reserve(total));
+        SimpleVector<Value> values(::Reserve(total));
+        size_t old_pos = 0;
+        for (size_t i = 0; i < added_keys.GetSize(); ++i) {
+            while (old_pos < keys_.GetSize() && comp_(keys_[old_pos], added_keys[i])) {
+                keys.PushBack(std::move_if_noexcept(keys_[old_pos]));
+                values.PushBack(std::move_if_noexcept(values_[old_pos]));
+                ++old_pos;
+            }
+            keys.PushBack(std::move_if_noexcept(added_keys[i]));
+            values.PushBack(std::move_if_noexcept(added_values[i]));
+        }
+        for (; old_pos < keys_.GetSize(); ++old_pos) {
+            keys.PushBack(std::move_if_noexcept(keys_[old_pos]));
+            values.PushBack(std::move_if_noexcept(values_[old_pos]));
+        }
+        Replace(std::move(keys), std::move(values));
+    }
+
+    // Вставляет пару, если ключа ещё нет. Возвращает указатель на значение
+    // и признак того, что пара вставлена
+    std::pair<Value*, bool> Insert(const Key& key, const Value& value) {
+        return TryEmplace(key, value);
+    }
+
+    // Вставляет pair(key, Value(args...)), если ключа ещё нет
+    template <typename... Args>
+    std::pair<Value*, bool> TryEmplace(const Key& key, Args&&... args) {
+        const size_t pos = Position(key);
+        if (pos < keys_.GetSize() && !comp_(key, keys_[pos])) {
+            return {&values_[pos], false};
+        }
+        values_.Emplace(values_.cbegin() + pos, std::forward<Args>(args)...);
+        try {
+            keys_.Insert(keys_.cbegin() + pos, key);
+        } catch (...) {
+            values_.Erase(values_.cbegin() + pos);
+            throw;
+        }
+        index_.Rebuild(keys_.cbegin(), keys_.GetSize());
+        return {&values_[pos], true};
+    }
+
+    // Вставляет пару или присваивает значение имеющемуся ключу
+    std::pair<Value*, bool> InsertOrAssign(const Key& key, const Value& value) {
+        auto result = TryEmplace(key, value);
+        if (!result.second) {
+            *result.first = value;
+        }
+        return result;
+    }
+
+    // Возвращает значение по ключу, вставляя Value(), если ключа нет
+    Value& operator[](const Key& key) {
+        return *TryEmplace(key).first;
+    }
+
+    // Выбрасывает исключение std::out_of_range, если ключа нет
+    Value& At(const Key& key) {
+        Value* value = Find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("key not found");
+        }
+        return *value;
+    }
+
+    const Value& At(const Key& key) const {
+        const Value* value = Find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("key not found");
+        }
+        return *value;
+    }
+
+    // Возвращает указатель на значение по ключу либо nullptr
+    Value* Find(const Key& key) {
+        const size_t pos = FindPosition(key);
+        return pos == keys_.GetSize() ? nullptr : &values_[pos];
+    }
+
+    const Value* Find(const Key& key) const {
+        const size_t pos = FindPosition(key);
+        return pos == keys_.GetSize() ? nullptr : &values_[pos];
+    }
+
+    bool Contains(const Key& key) const {
+        return FindPosition(key) != keys_.GetSize();
+    }
+
+    // Удаляет пару по ключу. Возвращает количество удалённых пар (0 или 1)
+    size_t Erase(const Key& key) {
+        const size_t pos = FindPosition(key);
+        if (pos == keys_.GetSize()) {
+            return 0;
+        }
+        EraseRange(pos, pos + 1);
+        return 1;
+    }
+
+    // Удаляет пары с позициями [first, last) одним сдвигом хвоста в каждом столбце
+    void EraseRange(size_t first, size_t last) {
+        assert(first <= last && last <= keys_.GetSize());
+        keys_.Erase(keys_.cbegin() + first, keys_.cbegin() + last);
+        values_.Erase(values_.cbegin() + first, values_.cbegin() + last);
+        index_.Rebuild(keys_.cbegin(), keys_.GetSize());
+    }
+
+    // Возвращает позицию первого ключа не меньше key
+    size_t LowerBound(const Key& key) const {
+        return Position(key);
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+        values_.Reserve(capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+        index_.Rebuild(keys_.cbegin(), 0);
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    // Столбец отсортированных ключей
+    ConstSimpleVectorView<Key> Keys() const noexcept {
+        return keys_;
+    }
+
+    // Столбец значений в порядке ключей
+    SimpleVectorView<Value> Values() noexcept {
+        return values_;
+    }
+
+    ConstSimpleVectorView<Value> Values() const noexcept {
+        return values_;
+    }
+
+    void swap(FlatMap& other) noexcept {
+        keys_.swap(other.keys_);
+        values_.swap(other.values_);
+        std::swap(comp_, other.comp_);
+        std::swap(index_, other.index_);
+    }
+
+    friend bool operator==(const FlatMap& lhs, const FlatMap& rhs) {
+        return lhs.keys_ == rhs.keys_ && lhs.values_ == rhs.values_;
+    }
+
+    friend bool operator!=(const FlatMap& lhs, const FlatMap& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    size_t Position(const Key& key) const {
+        return index_.LowerBound(keys_.cbegin(), keys_.GetSize(), key, comp_);
+    }
+
+    // Возвращает позицию ключа либо GetSize(), если его нет
+    size_t FindPosition(const Key& key) const {
+        const size_t pos = Position(key);
+        return pos < keys_.GetSize() && !comp_(key, keys_[pos]) ? pos : keys_.GetSize();
+    }
+
+    void Replace(SimpleVector<Key>&& keys, SimpleVector<Value>&& values) {
+        keys_.swap(keys);
+        values_.swap(values);
+        index_.Rebuild(keys_.cbegin(), keys_.GetSize());
+    }
+
+    SimpleVector<Key> keys_;
+    SimpleVector<Value> values_;
+    Compare comp_;
+    Index index_;
+};
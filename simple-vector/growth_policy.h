@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#include "arena.h"
+
+// Политики роста SimpleVector. Политика — тип со статической функцией
+//     static size_t NextCapacity(size_t capacity, size_t required, size_t element_size);
+// которая по текущей вместимости и требуемому числу элементов возвращает новую вместимость.
+// Результат меньше required вектор всё равно увеличит до required.
+// Чтобы вектор с политикой можно было использовать в константных выражениях (C++20), функция должна быть constexpr.
+namespace simple_vector_detail {
+
+// Умножение без переполнения: при переполнении возвращает максимум size_t
+constexpr size_t SaturatingMul(size_t value, size_t factor) noexcept {
+    if (factor != 0 && value > std::numeric_limits<size_t>::max() / factor) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return value * factor;
+}
+
+// Округляет вместимость вверх так, чтобы буфер занимал целое число блоков по block_bytes байт
+constexpr size_t RoundCapacityToBytes(size_t capacity, size_t element_size, size_t block_bytes) noexcept {
+    const size_t bytes = SaturatingMul(capacity, element_size);
+    if (bytes > std::numeric_limits<size_t>::max() - block_bytes) {
+        return capacity;
+    }
+    const size_t rounded = (bytes + block_bytes - 1) / block_bytes * block_bytes;
+    return std::max(capacity, rounded / element_size);
+}
+
+} // namespace simple_vector_detail
+
+// Рост в Numerator / Denominator раз (но не меньше чем на один элемент)
+template <size_t Numerator, size_t Denominator>
+struct FactorGrowth {
+    static_assert(Numerator > Denominator && Denominator > 0, "Growth factor must be greater than 1");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        const size_t whole = simple_vector_detail::SaturatingMul(capacity / Denominator, Numerator);
+        const size_t rest = capacity % Denominator * Numerator / Denominator;
+        const size_t grown = whole > std::numeric_limits<size_t>::max() - rest ? whole : whole + rest;
+        return std::max({required, grown, capacity + 1});
+    }
+};
+
+// Удвоение вместимости: политика по умолчанию
+using DoublingGrowth = FactorGrowth<2, 1>;
+
+// Рост в полтора раза: освобождённые ранее буферы чаще подходят для повторного использования
+using OneAndHalfGrowth = FactorGrowth<3, 2>;
+
+// Ограничивает шаг роста политики Base величиной MaxStepBytes байт:
+// огромные векторы растут линейно, а не удвоением
+template <typename Base, size_t MaxStepBytes>
+struct CappedGrowth {
+    static_assert(MaxStepBytes > 0, "Max growth step must be positive");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t next = Base::NextCapacity(capacity, required, element_size);
+        const size_t max_step = std::max(MaxStepBytes / element_size, static_cast<size_t>(1));
+        if (next > capacity && next - capacity > max_step) {
+            return std::max(required, capacity + max_step);
+        }
+        return next;
+    }
+};
+
+// Округляет результат политики Base до целого числа страниц памяти по PageSize байт
+template <typename Base, size_t PageSize = 4096>
+struct PageRoundedGrowth {
+    static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "Page size must be a power of two");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t next = Base::NextCapacity(capacity, required, element_size);
+        return simple_vector_detail::RoundCapacityToBytes(next, element_size, PageSize);
+    }
+};
+
+// Округляет результат политики Base до класса размера SizeClassPool,
+// а буферы больше самого крупного класса — до страниц по PageSize байт.
+// Вместе с PoolAllocator так используется весь выделенный блок
+template <typename Base, size_t PageSize = 4096>
+struct SizeClassRoundedGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t next = Base::NextCapacity(capacity, required, element_size);
+        const size_t bytes = simple_vector_detail::SaturatingMul(next, element_size);
+        if (bytes <= SizeClassPool::kMaxPooledSize) {
+            return std::max(next, SizeClassPool::SizeClassOf(bytes) / element_size);
+        }
+        return simple_vector_detail::RoundCapacityToBytes(next, element_size, PageSize);
+    }
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#include "parallel.h"
+#include "simple_vector.h"
+
+// Аллокатор для очень больших векторов (Linux): память берётся через mmap, выровненной
+// по размеру большой страницы (2 МиБ или 1 ГиБ), и помечается MADV_HUGEPAGE, чтобы ядро
+// отображало её большими страницами и сократило промахи TLB. Для 1 ГиБ сначала пробуется
+// MAP_HUGETLB (нужны заранее зарезервированные страницы), затем — прозрачные большие страницы.
+// Размещением по узлам NUMA управляет mbind: локально (политика процесса, первое касание),
+// чередованием по всем узлам или на заданном узле.
+// Большие страницы и NUMA — подсказки: если ядро их не поддерживает, память выделяется как обычно.
+// Выделения меньше kLargePageThreshold байт идут в обычный operator new
+
+enum class LargePageSize : size_t {
+    k2MiB = size_t{2} << 20,
+    k1GiB = size_t{1} << 30,
+};
+
+enum class NumaPolicy {
+    kLocal,       // политика процесса: страница попадает на узел потока, первым её коснувшегося
+    kInterleave,  // страницы чередуются по всем доступным узлам
+    kBind,        // только узел node
+    kPreferred,   // по возможности узел node
+};
+
+struct LargePageOptions {
+    LargePageSize page_size = LargePageSize::k2MiB;
+    NumaPolicy numa_policy = NumaPolicy::kLocal;
+    int node = 0;
+};
+
+inline constexpr size_t kLargePageThreshold = size_t{1} << 20;
+
+namespace simple_vector_detail {
+
+inline size_t RoundUpTo(size_t value, size_t alignment) noexcept {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Отображает bytes байт (кратно alignment) по адресу, кратному alignment.
+// Лишнее начало и хвост отображения сразу освобождаются
+inline void* MapAligned(size_t bytes, size_t alignment) noexcept {
+    const size_t padded = bytes + alignment;
+    void* raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const auto start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = RoundUpTo(start, alignment);
+    if (aligned > start) {
+        ::munmap(raw, aligned - start);
+    }
+    const uintptr_t tail = aligned + bytes;
+    if (start + padded > tail) {
+        ::munmap(reinterpret_cast<void*>(tail), start + padded - tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+inline void ApplyNumaPolicy(void* ptr, size_t bytes, const LargePageOptions& options) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+    // значения из <linux/mempolicy.h>; libnuma не нужна
+    constexpr int mpol_preferred = 1;
+    constexpr int mpol_bind = 2;
+    constexpr int mpol_interleave = 3;
+    unsigned long mask = 0;
+    int mode = 0;
+    switch (options.numa_policy) {
+    case NumaPolicy::kLocal:
+        return;
+    case NumaPolicy::kInterleave:
+        // ядро пересекает маску с узлами, доступными процессу
+        mask = ~0ul;
+        mode = mpol_interleave;
+        break;
+    case NumaPolicy::kBind:
+    case NumaPolicy::kPreferred:
+        if (options.node < 0 || options.node >= std::numeric_limits<unsigned long>::digits) {
+            return;
+        }
+        mask = 1ul << options.node;
+        mode = options.numa_policy == NumaPolicy::kBind ? mpol_bind : mpol_preferred;
+        break;
+    }
+    const int saved_errno = errno;
+    ::syscall(SYS_mbind, ptr, bytes, mode, &mask, std::numeric_limits<unsigned long>::digits + 1, 0);
+    errno = saved_errno;
+#else
+    (void)ptr;
+    (void)bytes;
+    (void)options;
+#endif
+}
+
+inline void* AllocateLargePages(size_t bytes, const LargePageOptions& options) {
+    const auto page = static_cast<size_t>(options.page_size);
+    const size_t rounded = RoundUpTo(bytes, page);
+    void* ptr = nullptr;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    if (options.page_size == LargePageSize::k1GiB) {
+        constexpr int huge_1gb = 30 << MAP_HUGE_SHIFT;
+        void* huge = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_1gb, -1, 0);
+        if (huge != MAP_FAILED) {
+            ptr = huge;
+        }
+    }
+#endif
+    if (ptr == nullptr) {
+        ptr = MapAligned(rounded, page);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+#if defined(MADV_HUGEPAGE)
+        ::madvise(ptr, rounded, MADV_HUGEPAGE);
+#endif
+    }
+    ApplyNumaPolicy(ptr, rounded, options);
+    return ptr;
+}
+
+inline void DeallocateLargePages(void* ptr, size_t bytes, const LargePageOptions& options) noexcept {
+    ::munmap(ptr, RoundUpTo(bytes, static_cast<size_t>(options.page_size)));
+}
+
+} // namespace simple_vector_detail
+
+template <typename T>
+class LargePageAllocator {
+public:
+    using value_type = T;
+
+    LargePageAllocator() noexcept = default;
+
+    LargePageAllocator(const LargePageOptions& options) noexcept
+        : options_(options) {
+    }
+
+    template <typename U>
+    LargePageAllocator(const LargePageAllocator<U>& other) noexcept
+        : options_(other.GetOptions()) {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+        if (bytes < kLargePageThreshold) {
+            return static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)}));
+        }
+        return static_cast<T*>(simple_vector_detail::AllocateLargePages(bytes, options_));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (bytes < kLargePageThreshold) {
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+        } else {
+            simple_vector_detail::DeallocateLargePages(ptr, bytes, options_);
+        }
+    }
+
+    const LargePageOptions& GetOptions() const noexcept {
+        return options_;
+    }
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    // Память освобождается одинаково при любом узле NUMA, важен лишь размер страницы
+    template <typename U>
+    bool operator==(const LargePageAllocator<U>& other) const noexcept {
+        return options_.page_size == other.GetOptions().page_size;
+    }
+
+    template <typename U>
+    bool operator!=(const LargePageAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    LargePageOptions options_;
+};
+
+// Политика роста для LargePageAllocator: буферы от kLargePageThreshold байт округляются
+// до целого числа больших страниц (их всё равно выделит mmap), маленькие растут как Base
+template <typename Base, size_t PageSize = static_cast<size_t>(LargePageSize::k2MiB)>
+struct LargePageGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t next = Base::NextCapacity(capacity, required, element_size);
+        if (simple_vector_detail::SaturatingMul(next, element_size) < kLargePageThreshold) {
+            return next;
+        }
+        return simple_vector_detail::RoundCapacityToBytes(next, element_size, PageSize);
+    }
+};
+
+// Вектор в больших страницах: LargePageSimpleVector<double> v(LargePageOptions{...});
+template <typename Type>
+using LargePageSimpleVector = SimpleVector<Type, LargePageAllocator<Type>, LargePageGrowth<DoublingGrowth>>;
+
+// Увеличивает вектор до new_size элементов и заполняет новые значением value в пуле потоков.
+// Память тривиальных типов не трогается до заполнения, поэтому каждую страницу первым
+// касается поток пула: при политике kLocal она размещается на его узле NUMA.
+// Границы кусков выровнены по большой странице, так что страница достаётся одному потоку.
+// Последующие проходы с тем же пулом и grain делят диапазон так же; какой поток возьмёт
+// кусок, решает планировщик с кражей задач, поэтому совпадение потоков не гарантировано
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void ParallelFirstTouch(SimpleVector<Type, Allocator, GrowthPolicy>& v, size_t new_size, const Type& value,
+                        ThreadPool& pool = DefaultThreadPool(), size_t page_size = static_cast<size_t>(LargePageSize::k2MiB)) {
+    const size_t old_size = v.GetSize();
+    v.ResizeDefaultInit(new_size);
+    if (new_size <= old_size) {
+        return;
+    }
+    Type* first = v.begin() + old_size;
+    Type* last = v.begin() + new_size;
+    const size_t parts = pool.GetThreadCount() + 1;
+    const size_t grain = std::max<size_t>((new_size - old_size + parts - 1) / parts, page_size / sizeof(Type));
+    ParallelForChunks(first, last, [&value](Type* chunk_first, Type* chunk_last) {
+        std::fill(chunk_first, chunk_last, value);
+    }, pool, grain, std::max(page_size, simple_vector_detail::kChunkAlignment<Allocator>));
+}
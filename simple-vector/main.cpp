@@ -1,9 +1,42 @@
+#include "async.h"
+#include "concurrent_simple_vector.h"
+#include "flat_map.h"
+#include "large_page_allocator.h"
+#include "mapped_simple_vector.h"
+#include "parallel.h"
+#include "segmented_simple_vector.h"
+#include "serialization.h"
+#include "shared_simple_vector.h"
 #include "simple_vector.h"
+#include "simple_vector_view.h"
+#include "small_simple_vector.h"
+#include "soa_simple_vector.h"
+#include "static_simple_vector.h"
+#include "stats.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <functional>
+#include <list>
+#include <memory_resource>
+#include <mutex>
 #include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -316,8 +349,2218 @@ void TestNoncopiableErase() {
     auto it = v.Erase(v.begin());
     assert(it->GetX() == 1);
     cout << "Done!" << endl << endl;
-    
-    cout << "All tests passed successfully!" << endl;
+}
+
+// Считает живые объекты, чтобы проверять конструирование и разрушение элементов
+struct Counted {
+    static inline int alive = 0;
+    static inline int constructed = 0;
+
+    Counted() : Counted(0) {
+    }
+    explicit Counted(int v)
+        : value(v) {
+        ++alive;
+        ++constructed;
+    }
+    Counted(const Counted& other)
+        : value(other.value) {
+        ++alive;
+        ++constructed;
+    }
+    Counted(Counted&& other) noexcept
+        : value(exchange(other.value, 0)) {
+        ++alive;
+        ++constructed;
+    }
+    Counted& operator=(const Counted&) = default;
+    Counted& operator=(Counted&& other) noexcept {
+        value = exchange(other.value, 0);
+        return *this;
+    }
+    ~Counted() {
+        --alive;
+    }
+
+    static void Reset() {
+        alive = 0;
+        constructed = 0;
+    }
+
+    int value;
+};
+
+// Тип без конструктора по умолчанию
+struct NoDefault {
+    explicit NoDefault(int v)
+        : value(v) {
+    }
+    int value;
+};
+
+void TestRawStorage() {
+    cout << "Test raw storage" << endl;
+    Counted::Reset();
+    {
+        // резервирование не создаёт объектов
+        SimpleVector<Counted> v(Reserve(100));
+        assert(Counted::constructed == 0);
+        v.Reserve(1000);
+        assert(Counted::constructed == 0);
+
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(Counted(i));
+        }
+        assert(Counted::alive == 10);
+
+        // при перевыделении живыми остаются только size элементов
+        v.Reserve(5000);
+        assert(Counted::alive == 10);
+
+        v.Resize(3);
+        assert(Counted::alive == 3);
+        v.Erase(v.begin());
+        assert(Counted::alive == 2);
+        assert(v[0].value == 1 && v[1].value == 2);
+        v.Clear();
+        assert(Counted::alive == 0);
+        v.Resize(4);
+        assert(Counted::alive == 4);
+    }
+    assert(Counted::alive == 0);
+
+    {
+        SimpleVector<NoDefault> v;
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(NoDefault(i));
+        }
+        v.Insert(v.begin() + 2, NoDefault(42));
+        assert(v.GetSize() == 6);
+        assert(v[2].value == 42 && v[5].value == 4);
+    }
+
+    {
+        // вставка ссылки на собственный элемент при перевыделении
+        SimpleVector<int> v{1, 2, 3};
+        v.PushBack(v[0]);
+        v.Insert(v.begin(), v[3]);
+        assert((v == SimpleVector<int>{1, 1, 2, 3, 1}));
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestPolymorphicAllocator() {
+    cout << "Test polymorphic allocator" << endl;
+    std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    {
+        PmrSimpleVector<int> v(&arena);
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        v.Insert(v.begin(), -1);
+        assert(v.GetSize() == 101 && v[0] == -1 && v[100] == 99);
+        assert(v.GetAllocator().resource() == &arena);
+
+        // копия получает ресурс по умолчанию, копия с аллокатором — заданный
+        PmrSimpleVector<int> copy(v);
+        assert(copy.GetAllocator().resource() == std::pmr::get_default_resource());
+        PmrSimpleVector<int> arena_copy(v, &arena);
+        assert(arena_copy == v);
+
+        // перемещение между разными ресурсами переносит элементы по одному
+        copy = std::move(arena_copy);
+        assert(copy == v);
+        assert(copy.GetAllocator().resource() == std::pmr::get_default_resource());
+    }
+    {
+        // ресурс передаётся элементам через uses-allocator construction
+        PmrSimpleVector<std::pmr::string> v(&arena);
+        v.PushBack(std::pmr::string("a rather long string that does not fit into SSO"));
+        v.Resize(3);
+        assert(v[0].get_allocator().resource() == &arena);
+        assert(v[2].get_allocator().resource() == &arena);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestArena() {
+    cout << "Test bump arena and pool allocators" << endl;
+    {
+        BumpArena arena(1024);
+        ArenaSimpleVector<int> v(arena);
+        v.Reserve(8);
+        const int* data = v.begin();
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        // вектор владеет последним выделением арены: буфер рос на месте
+        assert(v.begin() == data);
+        v.Reserve(200);
+        assert(v.begin() == data && v.GetCapacity() == 200);
+
+        // после чужого выделения расширение на месте невозможно, элементы переносятся
+        ArenaSimpleVector<int> other(arena);
+        other.PushBack(1);
+        v.Reserve(400);
+        assert(v.begin() != data);
+        for (int i = 0; i < 100; ++i) {
+            assert(v[i] == i);
+        }
+    }
+    {
+        // рост за пределы блока арены
+        BumpArena arena(256);
+        ArenaSimpleVector<size_t> v(arena);
+        for (size_t i = 0; i < 10000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.GetSize() == 10000 && v[9999] == 9999);
+        v.Clear();
+        arena.Reset();
+        assert(arena.GetReservedBytes() > 0);
+    }
+    {
+        ArenaSimpleVector<string> v(ThreadLocalArena());
+        v.PushBack("a rather long string that does not fit into SSO"s);
+        v.Insert(v.begin(), "front"s);
+        assert(v[0] == "front"s && v.GetSize() == 2);
+    }
+    {
+        SizeClassPool pool;
+        SimpleVector<int, PoolAllocator<int>> v(pool);
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        const int* data = v.begin();
+        SimpleVector<int, PoolAllocator<int>> copy(v, pool);
+        assert(copy == v);
+        v = SimpleVector<int, PoolAllocator<int>>(pool);
+        // освобождённый блок того же класса размера переиспользуется
+        SimpleVector<int, PoolAllocator<int>> reused(Reserve(1000), pool);
+        assert(reused.begin() == data);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestSmallSimpleVector() {
+    cout << "Test small simple vector" << endl;
+    {
+        SmallSimpleVector<int, 4> v;
+        assert(v.IsInline() && v.GetCapacity() == 4);
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.IsInline());
+        v.Insert(v.begin(), -1);
+        // пятый элемент переносит данные в кучу
+        assert(!v.IsInline() && v.GetCapacity() == 8);
+        assert((v == SmallSimpleVector<int, 4>{-1, 0, 1, 2, 3}));
+        v.Erase(v.begin() + 1);
+        assert((v == SmallSimpleVector<int, 4>{-1, 1, 2, 3}));
+        assert((SmallSimpleVector<int, 4>{1, 2} < SmallSimpleVector<int, 4>{1, 3}));
+        v.Resize(10);
+        assert(v.GetSize() == 10 && v[9] == 0);
+        assert(v.At(3) == 3);
+    }
+    {
+        // перемещение и обмен между внутренним буфером и кучей
+        SmallSimpleVector<X, 2> small;
+        small.PushBack(X(1));
+        SmallSimpleVector<X, 2> big;
+        for (size_t i = 0; i < 5; ++i) {
+            big.PushBack(X(i));
+        }
+        small.swap(big);
+        assert(small.GetSize() == 5 && !small.IsInline() && small[4].GetX() == 4);
+        assert(big.GetSize() == 1 && big.IsInline() && big[0].GetX() == 1);
+
+        SmallSimpleVector<X, 2> moved(std::move(small));
+        assert(moved.GetSize() == 5 && small.IsEmpty());
+        moved = std::move(big);
+        assert(moved.GetSize() == 1 && moved[0].GetX() == 1);
+    }
+    Counted::Reset();
+    {
+        SmallSimpleVector<Counted, 8> v(Reserve(4));
+        assert(Counted::constructed == 0);
+        v.PushBack(Counted(1));
+        SmallSimpleVector<Counted, 8> copy = v;
+        v.Clear();
+        assert(Counted::alive == 1 && copy[0].value == 1);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+// Дескриптор в духе unique_ptr: нетривиальный, но переносимый побайтово
+class Handle {
+public:
+    static inline int live = 0;
+
+    explicit Handle(int value)
+        : ptr_(new int(value)) {
+        ++live;
+    }
+    Handle(Handle&& other) noexcept
+        : ptr_(exchange(other.ptr_, nullptr)) {
+        ++live;
+    }
+    Handle& operator=(Handle&& other) noexcept {
+        swap(ptr_, other.ptr_);
+        return *this;
+    }
+    ~Handle() {
+        delete ptr_;
+        --live;
+    }
+
+    int Get() const {
+        return *ptr_;
+    }
+
+private:
+    int* ptr_;
+};
+
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type {};
+
+void TestTriviallyRelocatable() {
+    cout << "Test trivially relocatable fast path" << endl;
+    static_assert(kIsTriviallyRelocatable<int>);
+    static_assert(!kIsTriviallyRelocatable<string>);
+    {
+        SimpleVector<Handle> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(Handle(i));
+        }
+        // при побайтовом переносе деструкторы старых копий не вызываются
+        assert(Handle::live == 10);
+        v.Insert(v.begin() + 3, Handle(100));
+        v.Insert(v.begin(), Handle(200));
+        assert(Handle::live == 12);
+        assert(v[0].Get() == 200 && v[4].Get() == 100 && v[11].Get() == 9);
+        v.Erase(v.begin() + 4);
+        v.Erase(v.begin());
+        assert(Handle::live == 10);
+        for (int i = 0; i < 10; ++i) {
+            assert(v[i].Get() == i);
+        }
+    }
+    assert(Handle::live == 0);
+    {
+        SmallSimpleVector<Handle, 2> v;
+        for (int i = 0; i < 5; ++i) {
+            v.Insert(v.begin(), Handle(i));
+        }
+        v.Erase(v.begin() + 1);
+        assert(v.GetSize() == 4 && v[0].Get() == 4 && v[1].Get() == 2);
+    }
+    assert(Handle::live == 0);
+    {
+        SimpleVector<int> v{1, 2, 3, 4, 5};
+        v.Insert(v.begin() + 2, 42);
+        v.Erase(v.begin());
+        assert((v == SimpleVector<int>{2, 42, 3, 4, 5}));
+    }
+    cout << "Done!" << endl << endl;
+}
+
+// Перемещение может бросить исключение, копирование бросает на заданном вызове
+struct ThrowingMove {
+    static inline int copies = 0;
+    static inline int copies_until_throw = -1;
+
+    explicit ThrowingMove(int v)
+        : value(v) {
+    }
+    ThrowingMove(const ThrowingMove& other)
+        : value(other.value) {
+        if (copies_until_throw == 0) {
+            throw runtime_error("copy failed");
+        }
+        --copies_until_throw;
+        ++copies;
+    }
+    ThrowingMove(ThrowingMove&& other) noexcept(false)
+        : value(other.value) {
+        other.value = -1;
+    }
+    ThrowingMove& operator=(const ThrowingMove&) = default;
+    ThrowingMove& operator=(ThrowingMove&&) = default;
+
+    int value;
+};
+
+void TestNoexceptMove() {
+    cout << "Test noexcept move and strong exception guarantee" << endl;
+    static_assert(is_nothrow_move_constructible_v<SimpleVector<int>>);
+    static_assert(is_nothrow_move_assignable_v<SimpleVector<int>>);
+    static_assert(is_nothrow_move_constructible_v<SimpleVector<X>>);
+    static_assert(is_nothrow_move_constructible_v<SmallSimpleVector<int, 4>>);
+
+    Counted::Reset();
+    {
+        // внешний std::vector перемещает вложенные векторы, а не копирует их элементы
+        vector<SimpleVector<Counted>> outer;
+        for (int i = 0; i < 20; ++i) {
+            outer.push_back(SimpleVector<Counted>(3));
+        }
+        assert(Counted::constructed == 60);
+    }
+    {
+        // при росте элементы с бросающим перемещением копируются
+        SimpleVector<ThrowingMove> v;
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(ThrowingMove(i));
+        }
+        ThrowingMove::copies = 0;
+        v.Reserve(100);
+        assert(ThrowingMove::copies == 4);
+
+        // исключение при копировании не меняет вектор
+        ThrowingMove::copies_until_throw = 2;
+        try {
+            v.Reserve(1000);
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        ThrowingMove::copies_until_throw = -1;
+        assert(v.GetCapacity() == 100 && v.GetSize() == 4);
+        for (int i = 0; i < 4; ++i) {
+            assert(v[i].value == i);
+        }
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestGrowthPolicy() {
+    cout << "Test growth policies" << endl;
+    assert(DoublingGrowth::NextCapacity(0, 1, 4) == 1);
+    assert(DoublingGrowth::NextCapacity(8, 9, 4) == 16);
+    assert(OneAndHalfGrowth::NextCapacity(1, 2, 4) == 2);
+    assert(OneAndHalfGrowth::NextCapacity(10, 11, 4) == 15);
+    // шаг роста ограничен 1 КиБ = 256 элементов по 4 байта
+    assert((CappedGrowth<DoublingGrowth, 1024>::NextCapacity(1000, 1001, 4) == 1256));
+    assert((CappedGrowth<DoublingGrowth, 1024>::NextCapacity(1000, 5000, 4) == 5000));
+    // до целой страницы: 4096 / 8 = 512 элементов
+    assert((PageRoundedGrowth<DoublingGrowth>::NextCapacity(100, 101, 8) == 512));
+    assert((SizeClassRoundedGrowth<OneAndHalfGrowth>::NextCapacity(10, 11, 4) == 16));
+
+    {
+        SimpleVector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        size_t reallocations = 0;
+        size_t capacity = v.GetCapacity();
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+            if (v.GetCapacity() != capacity) {
+                assert(capacity == 0 || v.GetCapacity() <= capacity * 3 / 2 + 1);
+                capacity = v.GetCapacity();
+                ++reallocations;
+            }
+        }
+        assert(reallocations > 10 && v[999] == 999);
+        v.Insert(v.begin(), -1);
+        assert(v[0] == -1 && v[1000] == 999);
+    }
+    {
+        SimpleVector<size_t, std::allocator<size_t>, PageRoundedGrowth<DoublingGrowth>> v;
+        v.PushBack(1);
+        assert(v.GetCapacity() == 4096 / sizeof(size_t));
+    }
+    {
+        SmallSimpleVector<int, 4, std::allocator<int>, OneAndHalfGrowth> v{1, 2, 3, 4};
+        v.PushBack(5);
+        assert(v.GetCapacity() == 6);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+// Сообщение с несколькими строками: считает перемещения и копирования
+struct Message {
+    static inline int moves = 0;
+    static inline int copies = 0;
+
+    Message(string from_value, string to_value, int id_value)
+        : from(std::move(from_value)), to(std::move(to_value)), id(id_value) {
+    }
+    Message(const Message& other)
+        : from(other.from), to(other.to), id(other.id) {
+        ++copies;
+    }
+    Message(Message&& other) noexcept
+        : from(std::move(other.from)), to(std::move(other.to)), id(other.id) {
+        ++moves;
+    }
+    Message& operator=(const Message&) = default;
+    Message& operator=(Message&& other) noexcept {
+        from = std::move(other.from);
+        to = std::move(other.to);
+        id = other.id;
+        ++moves;
+        return *this;
+    }
+
+    string from;
+    string to;
+    int id;
+};
+
+void TestEmplace() {
+    cout << "Test EmplaceBack and Emplace" << endl;
+    {
+        SimpleVector<Message> v(Reserve(4));
+        Message::moves = Message::copies = 0;
+        Message& first = v.EmplaceBack("alice"s, "bob"s, 1);
+        assert(&first == &v[0] && first.id == 1);
+        v.EmplaceBack("bob"s, "alice"s, 2);
+        // элемент создан прямо в памяти вектора, без временного объекта
+        assert(Message::moves == 0 && Message::copies == 0);
+
+        auto it = v.Emplace(v.end(), "carol"s, "dave"s, 3);
+        assert(it == v.begin() + 2 && Message::moves == 0);
+        it = v.Emplace(v.begin(), "eve"s, "frank"s, 0);
+        assert(it == v.begin() && it->from == "eve"s);
+        assert(v.GetSize() == 4 && v[3].id == 3 && v[1].id == 1);
+        assert(Message::copies == 0);
+        // вставка с перевыделением тоже создаёт элемент сразу на месте
+        Message::moves = 0;
+        v.Emplace(v.begin() + 2, "x"s, "y"s, 42);
+        assert(v[2].id == 42 && Message::moves == 4);
+    }
+    {
+        SimpleVector<X> v;
+        for (size_t i = 0; i < 5; ++i) {
+            const X& added = v.EmplaceBack(i);
+            assert(added.GetX() == i);
+        }
+        v.Emplace(v.begin() + 1, 100);
+        assert(v[1].GetX() == 100 && v[5].GetX() == 4);
+    }
+    {
+        // аргумент ссылается на элемент самого вектора
+        SimpleVector<string> v{"a"s, "b"s};
+        v.EmplaceBack(v[0]);
+        v.Emplace(v.begin(), v[2]);
+        v.Emplace(v.begin() + 1, v[0]);
+        assert((v == SimpleVector<string>{"a"s, "a"s, "a"s, "b"s, "a"s}));
+    }
+    {
+        SmallSimpleVector<Message, 2> v;
+        v.EmplaceBack("a"s, "b"s, 1);
+        v.EmplaceBack("c"s, "d"s, 2);
+        v.Emplace(v.begin(), "e"s, "f"s, 0);
+        assert(v.GetSize() == 3 && v[0].id == 0 && v[2].id == 2);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestRangeOperations() {
+    cout << "Test bulk range operations" << endl;
+    {
+        SimpleVector<int> v;
+        const int chunk[] = {1, 2, 3, 4, 5};
+        v.Append(begin(chunk), end(chunk));
+        assert(v.GetCapacity() == 5);
+        v.Append(begin(chunk), end(chunk));
+        assert((v == SimpleVector<int>{1, 2, 3, 4, 5, 1, 2, 3, 4, 5}));
+
+        v.Insert(v.begin() + 1, 3, 0);
+        assert((v == SimpleVector<int>{1, 0, 0, 0, 2, 3, 4, 5, 1, 2, 3, 4, 5}));
+        auto it = v.Erase(v.begin() + 1, v.begin() + 4);
+        assert(*it == 2 && v.GetSize() == 10);
+        it = v.Erase(v.begin() + 5, v.end());
+        assert(it == v.end() && (v == SimpleVector<int>{1, 2, 3, 4, 5}));
+
+        v.Assign(begin(chunk) + 3, end(chunk));
+        assert((v == SimpleVector<int>{4, 5}));
+    }
+    {
+        // нетривиальный тип: вставка с хвостом длиннее и короче диапазона, с перевыделением и без
+        const vector<string> words = {"a"s, "b"s, "c"s};
+        SimpleVector<string> v(Reserve(32));
+        v.Append(words.begin(), words.end());
+        v.Insert(v.begin() + 1, words.begin(), words.begin() + 1);
+        assert((v == SimpleVector<string>{"a"s, "a"s, "b"s, "c"s}));
+        v.Insert(v.begin() + 3, words.begin(), words.end());
+        assert((v == SimpleVector<string>{"a"s, "a"s, "b"s, "a"s, "b"s, "c"s, "c"s}));
+        const list<string> more(40, "x"s);
+        v.Insert(v.begin(), more.begin(), more.end());
+        assert(v.GetSize() == 47 && v[39] == "x"s && v[40] == "a"s && v[46] == "c"s);
+        v.Insert(v.begin() + 2, 2, v[45]);
+        assert(v[2] == "c"s && v[3] == "c"s && v[4] == "x"s);
+
+        v.Erase(v.begin(), v.begin() + 42);
+        assert((v == SimpleVector<string>{"a"s, "a"s, "b"s, "a"s, "b"s, "c"s, "c"s}));
+        v.Assign(words.begin(), words.end());
+        assert((v == SimpleVector<string>{"a"s, "b"s, "c"s}));
+        v.Assign(more.begin(), more.end());
+        assert(v.GetSize() == 40 && v[39] == "x"s);
+    }
+    {
+        // однопроходные итераторы
+        istringstream input("1 2 3 4");
+        SimpleVector<int> v{10, 20};
+        v.Insert(v.begin() + 1, istream_iterator<int>(input), istream_iterator<int>());
+        assert((v == SimpleVector<int>{10, 1, 2, 3, 4, 20}));
+        istringstream other("7 8");
+        v.Assign(istream_iterator<int>(other), istream_iterator<int>());
+        assert((v == SimpleVector<int>{7, 8}));
+    }
+    Counted::Reset();
+    {
+        SimpleVector<Counted> v(5);
+        SimpleVector<Counted> source(3);
+        v.Insert(v.begin() + 2, source.begin(), source.end());
+        v.Erase(v.begin(), v.begin() + 6);
+        assert(Counted::alive == 5);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestShrinkToFit() {
+    cout << "Test ShrinkToFit and element destruction" << endl;
+    Counted::Reset();
+    {
+        SimpleVector<Counted> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        // удалённые элементы разрушаются сразу, а не при разрушении вектора
+        for (int i = 0; i < 90; ++i) {
+            v.PopBack();
+        }
+        assert(Counted::alive == 10 && v.GetCapacity() == 128);
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 10 && Counted::alive == 10);
+        for (int i = 0; i < 10; ++i) {
+            assert(v[i].value == i);
+        }
+        v.Resize(2);
+        assert(Counted::alive == 2);
+        v.Clear();
+        assert(Counted::alive == 0);
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 0 && v.begin() == nullptr);
+    }
+    {
+        SmallSimpleVector<Counted, 4> v;
+        for (int i = 0; i < 20; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Resize(6);
+        v.ShrinkToFit();
+        assert(!v.IsInline() && v.GetCapacity() == 6);
+        v.Resize(3);
+        v.ShrinkToFit();
+        assert(v.IsInline() && v.GetCapacity() == 4 && v[2].value == 2);
+        assert(Counted::alive == 3);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestDefaultInit() {
+    cout << "Test default-init resize" << endl;
+    {
+        SimpleVector<uint8_t> buffer(Reserve(64));
+        buffer.ResizeDefaultInit(64);
+        assert(buffer.GetSize() == 64 && buffer.GetCapacity() == 64);
+        iota(buffer.begin(), buffer.end(), 0);
+        // существующие значения сохраняются при росте
+        buffer.ResizeDefaultInit(100);
+        assert(buffer[63] == 63 && buffer.GetSize() == 100);
+        buffer.ResizeDefaultInit(10);
+        assert(buffer.GetSize() == 10 && buffer[9] == 9);
+    }
+    {
+        SimpleVector<float> v(1000, DefaultInit);
+        assert(v.GetSize() == 1000);
+        fill(v.begin(), v.end(), 1.5f);
+        assert(v[999] == 1.5f);
+    }
+    Counted::Reset();
+    {
+        // нетривиальные типы создаются конструктором по умолчанию
+        SimpleVector<Counted> v(3, DefaultInit);
+        v.ResizeDefaultInit(5);
+        assert(Counted::alive == 5 && v[4].value == 0);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestSimdKernels() {
+    cout << "Test SIMD kernels" << endl;
+    {
+        // длины вокруг ширины векторного регистра и хвосты
+        for (size_t size : {0u, 1u, 7u, 15u, 16u, 17u, 31u, 32u, 33u, 100u}) {
+            SimpleVector<int> a(size);
+            iota(a.begin(), a.end(), 0);
+            SimpleVector<int> b = a;
+            assert(a == b && !(a < b) && !(b < a));
+            if (size > 0) {
+                b[size - 1] = -1;
+                assert(a != b && b < a);
+                assert(a.Find(static_cast<int>(size - 1)) == a.end() - 1);
+                assert(a.Count(0) == 1);
+            }
+            assert(!a.Contains(-5));
+            SimpleVector<int> longer = a;
+            longer.PushBack(0);
+            assert(a < longer);
+        }
+    }
+    {
+        SimpleVector<int64_t> v(70, 3);
+        v[41] = -7;
+        v[69] = -7;
+        assert(v.Find(-7) - v.begin() == 41);
+        assert(v.Count(-7) == 2 && v.Count(3) == 68);
+        // 64-битное сравнение не должно срабатывать на совпадение одной половины
+        v[10] = (int64_t{1} << 32) | 3;
+        assert(v.Find((int64_t{5} << 32) | 3) == v.end());
+        const auto [lo, hi] = v.MinMax();
+        assert(lo == -7 && hi == ((int64_t{1} << 32) | 3));
+    }
+    {
+        SimpleVector<uint8_t> bytes(300, 255);
+        assert(bytes.Sum() == 300u * 255u);
+        bytes[200] = 0;
+        assert(bytes.Count(255) == 299 && bytes.Find(0) - bytes.begin() == 200);
+        SimpleVector<int8_t> a{-1, 2}, b{1, 2};
+        // знаковые элементы: порядок определяет значение, а не байт
+        assert(a < b);
+    }
+    {
+        SimpleVector<double> v{1.5, -2.0, 4.0, 0.5};
+        assert(v.Sum() == 4.0);
+        assert(v.MinMax() == make_pair(-2.0, 4.0));
+        // вещественные сравниваются по значению, а не побайтово
+        SimpleVector<double> zeros{0.0}, negative_zeros{-0.0};
+        assert(zeros == negative_zeros);
+    }
+    {
+        SimpleVector<string> words{"b"s, "a"s, "c"s, "a"s};
+        assert(words.Count("a"s) == 2 && words.Find("c"s) - words.begin() == 2);
+        assert(words.MinMax() == make_pair("a"s, "c"s));
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestParallelAlgorithms() {
+    cout << "Test parallel algorithms" << endl;
+    ThreadPool pool(3);
+    const size_t size = 200000;
+    const size_t cutoff = 1000;
+    {
+        SimpleVector<int> v(size);
+        ParallelFill(v, 2, pool, cutoff);
+        ParallelForEach(v, [](int& x) {
+            x *= 3;
+        }, pool, cutoff);
+        assert(v.Count(6) == size);
+        assert(ParallelReduce(v, int64_t{0}, plus<>(), pool, cutoff) == 6 * static_cast<int64_t>(size));
+        SimpleVector<double> halves;
+        ParallelTransform(v, halves, [](int x) {
+            return x / 2.0;
+        }, pool, cutoff);
+        assert(halves.GetSize() == size && halves.Count(3.0) == size);
+    }
+    {
+        // внутренние границы кусков начинаются со строки кэша
+        SimpleVector<int> v(size);
+        mutex chunks_mutex;
+        size_t covered = 0;
+        ParallelForChunks(v.begin(), v.end(), [&](int* first, int* last) {
+            lock_guard lock(chunks_mutex);
+            covered += static_cast<size_t>(last - first);
+            if (first != v.begin()) {
+                assert(reinterpret_cast<uintptr_t>(first) % kCacheLineSize == 0);
+            }
+        }, pool, cutoff);
+        assert(covered == size);
+    }
+    {
+        // порядок свёртки сохраняется для некоммутативной операции
+        SimpleVector<string> words(5000, "a"s);
+        words[0] = "b"s;
+        const string joined = ParallelReduce(words, ""s, plus<>(), pool, 100);
+        assert(joined.size() == 5000 && joined[0] == 'b');
+    }
+    {
+        SimpleVector<uint32_t> v(size);
+        uint32_t state = 12345;
+        for (uint32_t& x : v) {
+            state = state * 1103515245u + 12345u;
+            x = state >> 8;
+        }
+        ParallelSort(v, less<>(), pool, cutoff);
+        assert(is_sorted(v.begin(), v.end()));
+        ParallelSort(v, greater<>(), pool, cutoff);
+        assert(is_sorted(v.begin(), v.end(), greater<>()));
+    }
+    {
+        // маленькие векторы обрабатываются последовательно, исключения пробрасываются
+        SimpleVector<int> small(10, 1);
+        ParallelForEach(small, [](int& x) {
+            ++x;
+        }, pool);
+        assert(small.Count(2) == 10);
+        SimpleVector<int> v(size, 1);
+        bool thrown = false;
+        try {
+            ParallelForEach(v, [](int& x) {
+                if (x == 1) {
+                    throw runtime_error("boom");
+                }
+            }, pool, cutoff);
+        } catch (const runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestWorkStealing() {
+    cout << "Test work stealing" << endl;
+    {
+        // владелец забирает задачи в обратном порядке, воры — в прямом
+        simple_vector_detail::WorkStealingDeque<int> deque(2);
+        int values[5] = {0, 1, 2, 3, 4};
+        for (int& value : values) {
+            deque.Push(&value);
+        }
+        int* const stolen_first = deque.Steal();
+        int* const popped_last = deque.Pop();
+        int* const stolen_second = deque.Steal();
+        int* const popped_fourth = deque.Pop();
+        int* const popped_third = deque.Pop();
+        assert(stolen_first == &values[0] && popped_last == &values[4] && stolen_second == &values[1]);
+        assert(popped_fourth == &values[3] && popped_third == &values[2]);
+        int* const popped_empty = deque.Pop();
+        int* const stolen_empty = deque.Steal();
+        assert(popped_empty == nullptr && stolen_empty == nullptr);
+    }
+    {
+        // каждая задача достаётся ровно одному потоку
+        simple_vector_detail::WorkStealingDeque<int> deque;
+        const int count = 20000;
+        vector<int> items(count);
+        atomic<int> taken = 0;
+        atomic<bool> done = false;
+        vector<thread> thieves;
+        for (int t = 0; t < 3; ++t) {
+            thieves.emplace_back([&] {
+                while (!done.load()) {
+                    if (int* item = deque.Steal()) {
+                        ++*item;
+                        ++taken;
+                    }
+                }
+            });
+        }
+        for (int i = 0; i < count; ++i) {
+            deque.Push(&items[i]);
+            if (i % 3 == 0) {
+                if (int* item = deque.Pop()) {
+                    ++*item;
+                    ++taken;
+                }
+            }
+        }
+        while (int* item = deque.Pop()) {
+            ++*item;
+            ++taken;
+        }
+        while (taken.load() != count) {
+        }
+        done = true;
+        for (thread& thief : thieves) {
+            thief.join();
+        }
+        assert(all_of(items.begin(), items.end(), [](int x) {
+            return x == 1;
+        }));
+    }
+    ThreadPool pool(4);
+    {
+        // стоимость элементов различается в сотни раз
+        SimpleVector<uint64_t> v(20000);
+        iota(v.begin(), v.end(), 0);
+        SimpleVector<uint64_t> out;
+        ParallelTransform(v, out, [](uint64_t x) {
+            const uint64_t rounds = x % 1000 == 0 ? 2000 : 10;
+            uint64_t h = x;
+            for (uint64_t i = 0; i < rounds; ++i) {
+                h = h * 6364136223846793005ull + 1442695040888963407ull;
+            }
+            return h;
+        }, pool, 64);
+        assert(out.GetSize() == v.GetSize());
+        assert(out[0] != 0 || out[1] != 0);
+    }
+    {
+        // вложенный параллелизм не блокирует пул
+        SimpleVector<SimpleVector<int>> rows(16);
+        for (auto& row : rows) {
+            row.Resize(5000);
+        }
+        ParallelForEach(rows, [&pool](SimpleVector<int>& row) {
+            ParallelFill(row, 7, pool, 256);
+        }, pool, 1);
+        for (const auto& row : rows) {
+            assert(row.Count(7) == 5000);
+        }
+    }
+    {
+        // задачи из нескольких внешних потоков одновременно
+        vector<thread> clients;
+        atomic<int64_t> total = 0;
+        for (int c = 0; c < 4; ++c) {
+            clients.emplace_back([&pool, &total] {
+                SimpleVector<int> v(50000, 1);
+                total += ParallelReduce(v, int64_t{0}, plus<>(), pool, 1000);
+            });
+        }
+        for (thread& client : clients) {
+            client.join();
+        }
+        assert(total.load() == 200000);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+// Владеет памятью в куче, так что разрушение несозданной ячейки заметит ASan.
+// Копирование бросает исключение, когда счётчик copies_left доходит до нуля
+struct ThrowingCopyProbe {
+    static inline int alive = 0;
+    static inline int copies_left = 0;
+
+    explicit ThrowingCopyProbe(int v)
+        : value(std::make_unique<int>(v)) {
+        ++alive;
+    }
+    ThrowingCopyProbe(const ThrowingCopyProbe& other)
+        : value(std::make_unique<int>(*other.value)) {
+        if (--copies_left == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        ++alive;
+    }
+    ThrowingCopyProbe(ThrowingCopyProbe&& other) noexcept
+        : value(std::move(other.value)) {
+        ++alive;
+    }
+    ThrowingCopyProbe& operator=(ThrowingCopyProbe&& rhs) noexcept {
+        value = std::move(rhs.value);
+        return *this;
+    }
+    ~ThrowingCopyProbe() {
+        --alive;
+    }
+
+    std::unique_ptr<int> value;
+};
+
+struct DefaultThrowingCopyProbe : ThrowingCopyProbe {
+    DefaultThrowingCopyProbe()
+        : ThrowingCopyProbe(-1) {
+    }
+    explicit DefaultThrowingCopyProbe(int v)
+        : ThrowingCopyProbe(v) {
+    }
+};
+
+void TestConcurrentThrowingCopy() {
+    {
+        // ячейки после неудачной копии заполняются значением по умолчанию
+        ConcurrentSimpleVector<DefaultThrowingCopyProbe> v;
+        const DefaultThrowingCopyProbe value(5);
+        DefaultThrowingCopyProbe::copies_left = 3;
+        try {
+            v.GrowBy(6, value);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.GetSize() == 6 && !v.HasHoles());
+        assert(*v[1].value == 5 && *v[2].value == -1 && *v[5].value == -1);
+        assert(ThrowingCopyProbe::alive == 7);
+        v.Clear();
+        assert(ThrowingCopyProbe::alive == 1);
+    }
+    assert(ThrowingCopyProbe::alive == 0);
+    {
+        // без конструктора по умолчанию ячейки остаются пустыми и пропускаются
+        ConcurrentSimpleVector<ThrowingCopyProbe> v;
+        const ThrowingCopyProbe value(5);
+        v.EmplaceBack(1);
+        ThrowingCopyProbe::copies_left = 3;
+        try {
+            v.GrowBy(40, value);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        ThrowingCopyProbe::copies_left = 1;
+        try {
+            v.PushBack(value);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        v.EmplaceBack(2);
+        assert(v.GetSize() == 43 && v.HasHoles());
+        size_t built = 0;
+        v.ForEachSegment([&built](const ThrowingCopyProbe*, size_t count) {
+            built += count;
+        });
+        assert(built == 4 && ThrowingCopyProbe::alive == 5);
+        SimpleVector<ThrowingCopyProbe> flat = v.ToSimpleVector();
+        assert(flat.GetSize() == 4 && *flat[0].value == 1 && *flat[3].value == 2);
+        assert(v.IsEmpty() && !v.HasHoles());
+        v.EmplaceBack(3);
+    }
+    assert(ThrowingCopyProbe::alive == 0);
+}
+
+void TestConcurrentSimpleVector() {
+    cout << "Test concurrent append" << endl;
+    {
+        ConcurrentSimpleVector<int> v;
+        assert(v.IsEmpty());
+        int& first = v.PushBack(1);
+        v.GrowBy(100, 2);
+        // рост не переносит элементы
+        assert(&first == &v[0] && first == 1);
+        assert(v.GetSize() == 101 && v[100] == 2);
+        assert(count(v.begin(), v.end(), 2) == 100);
+        assert(v.end() - v.begin() == 101);
+        ConcurrentSimpleVector<int>::ConstIterator it = v.begin() + 100;
+        assert(*it == 2);
+        try {
+            v.At(101);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    {
+        const int threads = 8;
+        const int per_thread = 20000;
+        ConcurrentSimpleVector<int> v;
+        vector<thread> producers;
+        for (int t = 0; t < threads; ++t) {
+            producers.emplace_back([&v, t] {
+                for (int i = 0; i < per_thread; ++i) {
+                    v.PushBack(t * per_thread + i);
+                }
+                v.GrowBy(10, -1);
+            });
+        }
+        for (thread& producer : producers) {
+            producer.join();
+        }
+        assert(v.GetSize() == threads * (per_thread + 10));
+        SimpleVector<int> flat = v.ToSimpleVector();
+        assert(v.IsEmpty() && flat.GetSize() == threads * (per_thread + 10));
+        assert(flat.Count(-1) == threads * 10);
+        sort(flat.begin(), flat.end());
+        for (int i = 0; i < threads * per_thread; ++i) {
+            assert(flat[threads * 10 + i] == i);
+        }
+    }
+    Counted::Reset();
+    {
+        ConcurrentSimpleVector<Counted> v;
+        for (int i = 0; i < 50; ++i) {
+            v.EmplaceBack(i);
+        }
+        size_t segments = 0;
+        size_t total = 0;
+        v.ForEachSegment([&](Counted* first, size_t count) {
+            ++segments;
+            total += count;
+            assert(first->value == static_cast<int>(total - count));
+        });
+        // корзины по 16, 32 и 64 элемента
+        assert(segments == 3 && total == 50);
+        assert(Counted::alive == 50);
+        v.Clear();
+        assert(Counted::alive == 0 && v.IsEmpty());
+        v.EmplaceBack(7);
+    }
+    assert(Counted::alive == 0);
+    TestConcurrentThrowingCopy();
+    cout << "Done!" << endl << endl;
+}
+
+void TestSharedSimpleVector() {
+    cout << "Test copy-on-write vector" << endl;
+    {
+        SharedSimpleVector<int> empty;
+        assert(empty.IsEmpty() && empty.UseCount() == 0 && empty.begin() == empty.end());
+        SharedSimpleVector<int> table{1, 2, 3};
+        SharedSimpleVector<int> snapshot = table.Snapshot();
+        // копия разделяет буфер
+        assert(table.UseCount() == 2 && snapshot.begin() == table.begin());
+        table.PushBack(4);
+        // первое изменение копирует разделённый буфер, снимок не меняется
+        assert(table.UseCount() == 1 && snapshot.UseCount() == 1);
+        assert(table.GetSize() == 4 && snapshot.GetSize() == 3);
+        assert(snapshot.Get() == (SimpleVector<int>{1, 2, 3}));
+        // единственный владелец меняет буфер на месте
+        const int* data = table.begin();
+        table.Set(0, 10);
+        assert(table.begin() == data && table[0] == 10);
+        assert(snapshot < table && table != snapshot);
+    }
+    {
+        // изменения через Modify не видны снимку, взятому после них
+        SharedSimpleVector<int> table{1, 2, 3};
+        const size_t size = table.Modify([](SimpleVector<int>& v) {
+            v[0] = 7;
+            v.PushBack(4);
+            return v.GetSize();
+        });
+        assert(size == 4 && table[0] == 7);
+        SharedSimpleVector<int> snapshot = table.Snapshot();
+        table.Modify([](SimpleVector<int>& v) {
+            v[0] = 42;
+        });
+        table.Set(1, 43);
+        assert(snapshot[0] == 7 && snapshot[1] == 2 && table[0] == 42 && table[1] == 43);
+        try {
+            table.Set(10, 0);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    Counted::Reset();
+    {
+        SimpleVector<Counted> source(100);
+        SharedSimpleVector<Counted> shared(std::move(source));
+        Counted::constructed = 0;
+        {
+            vector<SharedSimpleVector<Counted>> copies(50, shared);
+            assert(shared.UseCount() == 51);
+        }
+        assert(Counted::constructed == 0 && shared.IsUnique());
+        SharedSimpleVector<Counted> other = shared;
+        other.Clear();
+        // очистка разделённого буфера не копирует элементы
+        assert(Counted::constructed == 0 && other.IsEmpty() && shared.GetSize() == 100);
+        SimpleVector<Counted> back = std::move(shared).ToSimpleVector();
+        assert(back.GetSize() == 100 && Counted::constructed == 0);
+    }
+    assert(Counted::alive == 0);
+    {
+        // читатели берут снимки, пока писатель меняет свою копию
+        SharedSimpleVector<int> table(1000, 1);
+        vector<thread> readers;
+        atomic<int64_t> sum = 0;
+        for (int r = 0; r < 4; ++r) {
+            readers.emplace_back([snapshot = table.Snapshot(), &sum] {
+                for (int i = 0; i < 100; ++i) {
+                    SharedSimpleVector<int> local = snapshot.Snapshot();
+                    sum += accumulate(local.begin(), local.end(), int64_t{0});
+                }
+            });
+        }
+        for (int i = 0; i < 1000; ++i) {
+            table.Set(i, 2);
+        }
+        for (thread& reader : readers) {
+            reader.join();
+        }
+        assert(sum.load() == 4 * 100 * 1000);
+        assert(table.Count(2) == 1000);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestMappedSimpleVector() {
+    cout << "Test memory-mapped vector" << endl;
+    struct Record {
+        uint64_t id;
+        double value;
+    };
+    const auto path = (filesystem::temp_directory_path() / ("simple_vector_mapped_" + to_string(::getpid()))).string();
+    {
+        MappedSimpleVector<Record> records(path, MappedOpenMode::kTruncate);
+        assert(records.IsEmpty() && records.begin() == records.end());
+        records.Advise(MappedAdvice::kSequential);
+        for (uint64_t i = 0; i < 10000; ++i) {
+            records.PushBack({i, i * 0.5});
+        }
+        // политика по умолчанию округляет вместимость до страниц
+        assert(records.GetSize() == 10000 && records.GetCapacity() >= 10000);
+        records.PopBack();
+        records.Flush();
+    }
+    {
+        // повторное открытие не копирует данные: элементы читаются прямо из отображения
+        MappedSimpleVector<Record> records(path, MappedOpenMode::kOpenExisting);
+        assert(records.GetSize() == 9999);
+        assert(records[1234].id == 1234 && records.At(9998).value == 9998 * 0.5);
+        records.Advise(MappedAdvice::kRandom);
+        records.Resize(10005);
+        assert(records[10004].id == 0);
+        records.ShrinkToFit();
+        assert(records.GetCapacity() == 10005);
+        assert(filesystem::file_size(path) == kMappedHeaderSize + 10005 * sizeof(Record));
+        MappedSimpleVector<Record> moved(std::move(records));
+        assert(moved.GetSize() == 10005 && records.GetSize() == 0);
+        moved.Clear();
+        moved.Flush(true);
+    }
+    {
+        // файл с другим размером элемента не открывается
+        bool thrown = false;
+        try {
+            MappedSimpleVector<uint32_t> wrong(path, MappedOpenMode::kOpenExisting);
+        } catch (const runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        thrown = false;
+        try {
+            MappedSimpleVector<uint32_t> missing(path + ".missing", MappedOpenMode::kOpenExisting);
+        } catch (const system_error& e) {
+            thrown = e.code() == errc::no_such_file_or_directory;
+        }
+        assert(thrown);
+    }
+    filesystem::remove(path);
+    cout << "Done!" << endl << endl;
+}
+
+void TestSerialization() {
+    cout << "Test serialization" << endl;
+    {
+        SimpleVector<uint64_t> v(1000);
+        iota(v.begin(), v.end(), 0);
+        stringstream buffer;
+        Serialize(v, buffer);
+        assert(buffer.str().size() == sizeof(SerializedHeader) + 1000 * sizeof(uint64_t));
+        SimpleVector<uint64_t> loaded(Reserve(2000));
+        Deserialize(buffer, loaded);
+        // чтение идёт в уже выделенный буфер
+        assert(loaded == v && loaded.GetCapacity() == 2000);
+    }
+    {
+        // пустой вектор
+        stringstream buffer;
+        Serialize(SimpleVector<int>(), buffer);
+        SimpleVector<int> loaded{1, 2};
+        Deserialize(buffer, loaded);
+        assert(loaded.IsEmpty());
+    }
+    {
+        // порча данных обнаруживается контрольной суммой
+        SimpleVector<int> v(100, 7);
+        stringstream buffer;
+        Serialize(v, buffer);
+        string bytes = buffer.str();
+        bytes[sizeof(SerializedHeader) + 17] ^= 1;
+        istringstream corrupted(bytes);
+        SimpleVector<int> loaded;
+        bool thrown = false;
+        try {
+            Deserialize(corrupted, loaded);
+        } catch (const runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && loaded.IsEmpty());
+        // несовпадение типа элемента
+        istringstream truncated(buffer.str());
+        SimpleVector<uint64_t> wrong;
+        thrown = false;
+        try {
+            Deserialize(truncated, wrong);
+        } catch (const runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    {
+        // файл, записанный на big-endian машине: байты заданы явно, контрольная сумма посчитана
+        // от них заранее, так что проверка не зависит от порядка байтов и кода записи этой машины
+        const unsigned char fixture[] = {
+            'S', 'V', 'S', 'E', 'R', 0, 0, 1,
+            0x01, 0x02, 0x03, 0x04,  0, 0, 0, 8,  0, 0, 0, 8,  0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 5,
+            0xAE, 0xFD, 0x87, 0x19, 0x36, 0xDC, 0x75, 0x37,
+            0, 0, 0, 0, 0, 0, 0, 1,
+            0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+            0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00, 0x11,
+            0, 0, 0, 0, 0, 0, 0, 42,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        };
+        static_assert(sizeof(fixture) == sizeof(SerializedHeader) + 5 * sizeof(uint64_t));
+        assert(Checksum64::Of(fixture + sizeof(SerializedHeader), 5 * sizeof(uint64_t)) == 0xAEFD871936DC7537ull);
+        istringstream foreign(string(reinterpret_cast<const char*>(fixture), sizeof(fixture)));
+        SimpleVector<uint64_t> loaded;
+        Deserialize(foreign, loaded);
+        assert((loaded == SimpleVector<uint64_t>{1, 0x0102030405060708ull, 0xAABBCCDDEEFF0011ull, 42, ~0ull}));
+        // для типа, не являющегося арифметическим, чужой порядок байтов — ошибка
+        struct Pair {
+            uint32_t first;
+            uint32_t second;
+        };
+        istringstream again(string(reinterpret_cast<const char*>(fixture), sizeof(fixture)));
+        SimpleVector<Pair> pairs;
+        bool thrown = false;
+        try {
+            Deserialize(again, pairs);
+        } catch (const runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && pairs.IsEmpty());
+    }
+    {
+        // запись одним writev в файл и чтение порциями
+        const auto path = (filesystem::temp_directory_path() / ("simple_vector_serialized_" + to_string(::getpid()))).string();
+        SimpleVector<double> v(100000);
+        for (size_t i = 0; i < v.GetSize(); ++i) {
+            v[i] = i * 0.25;
+        }
+        const int out = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        assert(out >= 0);
+        Serialize(v, out);
+        ::close(out);
+        const int in = ::open(path.c_str(), O_RDONLY);
+        SimpleVectorReader<double> reader(in);
+        assert(reader.GetCount() == v.GetSize());
+        SimpleVector<double> chunk;
+        size_t offset = 0;
+        while (size_t count = reader.ReadChunk(chunk, 30000)) {
+            assert(equal(chunk.begin(), chunk.end(), v.begin() + offset));
+            offset += count;
+        }
+        assert(offset == v.GetSize() && reader.GetRemaining() == 0);
+        ::close(in);
+        const int again = ::open(path.c_str(), O_RDONLY);
+        SimpleVector<double> loaded;
+        Deserialize(again, loaded);
+        ::close(again);
+        assert(loaded == v);
+        filesystem::remove(path);
+    }
+    {
+        // заголовок с огромным количеством элементов: ошибка формата, а не попытка выделить память
+        SerializedHeader header = simple_vector_detail::MakeHeader<uint64_t>(nullptr, 0);
+        header.count = uint64_t{1} << 40;
+        string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+        bytes.append(64, '\0');
+        istringstream forged(bytes);
+        SimpleVector<uint64_t> loaded;
+        bool thrown = false;
+        try {
+            Deserialize(forged, loaded);
+        } catch (const runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && loaded.IsEmpty() && loaded.GetCapacity() == 0);
+        // из канала длина неизвестна: буфер растёт по мере прихода данных
+        int fds[2];
+        const int piped = ::pipe(fds);
+        assert(piped == 0);
+        const ssize_t written = ::write(fds[1], bytes.data(), bytes.size());
+        assert(written == static_cast<ssize_t>(bytes.size()));
+        ::close(fds[1]);
+        thrown = false;
+        try {
+            Deserialize(fds[0], loaded);
+        } catch (const runtime_error&) {
+            thrown = true;
+        }
+        ::close(fds[0]);
+        assert(thrown && loaded.IsEmpty());
+    }
+    {
+        // из канала читается несколько порций, итоговая вместимость равна размеру
+        SimpleVector<uint64_t> v(300000);
+        iota(v.begin(), v.end(), 5);
+        int fds[2];
+        const int piped = ::pipe(fds);
+        assert(piped == 0);
+        thread writer([&v, out = fds[1]] {
+            Serialize(v, out);
+            ::close(out);
+        });
+        SimpleVector<uint64_t> loaded;
+        Deserialize(fds[0], loaded);
+        writer.join();
+        ::close(fds[0]);
+        assert(loaded == v && loaded.GetCapacity() == v.GetSize());
+        // из потока известной длины — одно выделение ровно под элементы
+        stringstream buffer;
+        Serialize(v, buffer);
+        SimpleVector<uint64_t> exact;
+        Deserialize(buffer, exact);
+        assert(exact == v && exact.GetCapacity() == v.GetSize());
+    }
+    {
+        // сумма не зависит от разбиения на порции
+        string data(1000, 'x');
+        iota(data.begin(), data.end(), 'a');
+        Checksum64 parts;
+        parts.Update(data.data(), 3);
+        parts.Update(data.data() + 3, 500);
+        parts.Update(data.data() + 503, 497);
+        assert(parts.Finish() == Checksum64::Of(data.data(), data.size()));
+        assert(Checksum64::Of(data.data(), 999) != Checksum64::Of(data.data(), 1000));
+        // эталонное значение одинаково на машинах с любым порядком байтов
+        unsigned char counting[64];
+        iota(begin(counting), end(counting), 0);
+        assert(Checksum64::Of(counting, sizeof(counting)) == 0x0474A27A8C5CA189ull);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestLargePageAllocator() {
+    cout << "Test large-page allocator" << endl;
+    ThreadPool pool(3);
+    {
+        LargePageSimpleVector<double> v;
+        const size_t size = 4 << 20;
+        ParallelFirstTouch(v, size, 1.5, pool);
+        assert(v.GetSize() == size && v.Count(1.5) == size);
+        // большой буфер выровнен по большой странице, вместимость — целое число страниц
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % (size_t{2} << 20) == 0);
+        assert(v.GetCapacity() * sizeof(double) % (size_t{2} << 20) == 0);
+        ParallelFirstTouch(v, size + 10, 2.0, pool);
+        assert(v[size - 1] == 1.5 && v[size + 9] == 2.0);
+        ParallelFirstTouch(v, 10, 0.0, pool);
+        assert(v.GetSize() == 10);
+    }
+    {
+        // маленькие векторы не занимают больших страниц
+        LargePageSimpleVector<int> small;
+        for (int i = 0; i < 100; ++i) {
+            small.PushBack(i);
+        }
+        assert(small.GetCapacity() < 1000 && small[99] == 99);
+    }
+    for (NumaPolicy policy : {NumaPolicy::kInterleave, NumaPolicy::kBind, NumaPolicy::kPreferred}) {
+        // политики NUMA — подсказки: на машине с одним узлом выделение просто работает
+        LargePageSimpleVector<uint64_t> v(LargePageOptions{LargePageSize::k2MiB, policy, 0});
+        v.Resize(1 << 18);
+        assert(v.Count(0) == v.GetSize());
+        LargePageSimpleVector<uint64_t> copy = v;
+        assert(copy == v);
+    }
+    {
+        // 1 ГиБ: без зарезервированных страниц используются прозрачные большие страницы
+        LargePageAllocator<char> alloc(LargePageOptions{LargePageSize::k1GiB});
+        char* data = alloc.allocate(size_t{4} << 20);
+        data[0] = 1;
+        data[(size_t{4} << 20) - 1] = 2;
+        alloc.deallocate(data, size_t{4} << 20);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestAlignedStorage() {
+    cout << "Test aligned storage" << endl;
+    {
+        AlignedSimpleVector<float, 64> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(static_cast<float>(i));
+            // выравнивание сохраняется при каждом перевыделении
+            assert(reinterpret_cast<uintptr_t>(v.begin()) % 64 == 0);
+        }
+        AlignedSimpleVector<float, 64> copy = v;
+        assert(reinterpret_cast<uintptr_t>(copy.begin()) % 64 == 0 && copy == v);
+        copy.ShrinkToFit();
+        assert(reinterpret_cast<uintptr_t>(copy.begin()) % 64 == 0);
+    }
+    {
+        AlignedSimpleVector<double, 4096> page_aligned(10, 1.0);
+        assert(reinterpret_cast<uintptr_t>(page_aligned.begin()) % 4096 == 0);
+        static_assert(simple_vector_detail::kChunkAlignment<AlignedAllocator<double, 4096>> == 4096);
+        static_assert(simple_vector_detail::kChunkAlignment<allocator<double>> == kCacheLineSize);
+    }
+    {
+        // параллельные куски начинаются с адресов, выровненных как сам буфер
+        ThreadPool pool(3);
+        AlignedSimpleVector<float, 256> v(100000, 1.0f);
+        mutex starts_mutex;
+        vector<const float*> starts;
+        ParallelForEach(v, [](float& x) {
+            x *= 2;
+        }, pool, 1000);
+        ParallelForChunks(v.begin(), v.end(), [&](float* first, float*) {
+            lock_guard lock(starts_mutex);
+            starts.push_back(first);
+        }, pool, 1000, simple_vector_detail::kChunkAlignment<AlignedAllocator<float, 256>>);
+        assert(starts.size() > 1);
+        for (const float* start : starts) {
+            assert(reinterpret_cast<uintptr_t>(start) % 256 == 0);
+        }
+        assert(v.Count(2.0f) == v.GetSize());
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestSoASimpleVector() {
+    cout << "Test SoA simple vector" << endl;
+    {
+        SoASimpleVector<int, double, string> soa;
+        assert(soa.IsEmpty() && soa.GetCapacity() == 0);
+        for (int i = 0; i < 100; ++i) {
+            soa.PushBack({i, i * 0.5, to_string(i)});
+        }
+        assert(soa.GetSize() == 100 && soa.GetCapacity() >= 100);
+
+        // столбцы непрерывны и одной длины
+        auto ids = soa.Column<0>();
+        auto weights = soa.Column<1>();
+        assert(ids.GetSize() == 100 && weights.GetSize() == 100);
+        assert(accumulate(ids.begin(), ids.end(), 0) == 4950);
+        assert(&ids[99] == ids.Data() + 99);
+
+        // строка — прокси-ссылки на поля в разных столбцах
+        auto [id, weight, name] = soa[10];
+        assert(id == 10 && weight == 5.0 && name == "10");
+        weight = 100.0;
+        assert(soa.Column<1>()[10] == 100.0);
+        soa[11] = make_tuple(-1, -1.0, string("x"));
+        assert(get<0>(soa[11]) == -1 && get<2>(soa[11]) == "x");
+        tuple<int, double, string> copy = soa[12];
+        assert(get<2>(copy) == "12");
+
+        auto it = soa.Erase(soa.begin() + 10, soa.begin() + 12);
+        assert(soa.GetSize() == 98 && get<0>(*it) == 12);
+        it = soa.Erase(soa.begin());
+        assert(get<0>(*it) == 1 && soa.Column<2>()[0] == "1");
+
+        size_t rows = 0;
+        for (auto [row_id, row_weight, row_name] : soa) {
+            assert(to_string(row_id) == row_name && row_weight == row_id * 0.5);
+            ++rows;
+        }
+        assert(rows == soa.GetSize());
+        // итераторы произвольного доступа: все сравнения и смещение слева
+        const auto first = soa.begin();
+        const auto last = soa.end();
+        assert(first < last && last > first && first <= first && last >= first && !(first > last) && !(last <= first));
+        assert(1 + first == first + 1 && get<0>(*(2 + first)) == get<0>(first[2]));
+        assert(last - (static_cast<ptrdiff_t>(soa.GetSize()) + first) == 0);
+        assert(soa.At(0) == soa[0]);
+        try {
+            soa.At(soa.GetSize());
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    {
+        SoASimpleVector<int, unique_ptr<int>> soa;
+        soa.Reserve(10);
+        assert(soa.GetCapacity() == 10);
+        auto [value, ptr] = soa.EmplaceBack(7, make_unique<int>(8));
+        assert(value == 7 && *ptr == 8);
+        soa.PushBack({1, make_unique<int>(2)});
+        soa.PopBack();
+        assert(soa.GetSize() == 1);
+        soa.Resize(5);
+        assert(soa.GetSize() == 5 && soa.Column<1>()[4] == nullptr);
+        const auto& const_soa = soa;
+        assert(*get<1>(const_soa[0]) == 8 && const_soa.Column<0>()[0] == 7);
+        soa.Clear();
+        assert(soa.IsEmpty() && soa.GetCapacity() >= 5);
+    }
+    {
+        // исключение при создании поля не оставляет столбцы разной длины
+        struct Throwing {
+            Throwing() = default;
+            Throwing(Throwing&&) noexcept = default;
+            Throwing(const Throwing&) {
+                throw runtime_error("copy");
+            }
+        };
+        SoASimpleVector<string, Throwing> soa;
+        soa.EmplaceBack("a", Throwing{});
+        const tuple<string, Throwing> row("b", Throwing{});
+        try {
+            soa.PushBack(row);
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        assert(soa.GetSize() == 1 && soa.Column<0>().GetSize() == 1 && soa.Column<1>().GetSize() == 1);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestStats() {
+    cout << "Test stats" << endl;
+    struct Probe {
+        int value = 0;
+    };
+    struct CopiedProbe {
+        CopiedProbe() = default;
+        CopiedProbe(const CopiedProbe&) {
+        }
+        // перемещение может бросить, поэтому при росте элементы копируются
+        CopiedProbe(CopiedProbe&&) {
+        }
+    };
+    if constexpr (SimpleVectorStats::kEnabled) {
+        {
+            SimpleVector<Probe> v;
+            for (int i = 0; i < 5; ++i) {
+                v.PushBack(Probe{i});
+            }
+            // вместимость 1, 2, 4, 8: четыре выделения, три переноса 1 + 2 + 4 элементов
+            const SimpleVectorStatsSnapshot stats = SimpleVectorStats::Snapshot<Probe>();
+            assert(stats.allocations == 4 && stats.deallocations == 3);
+            assert(stats.reallocations == 3 && stats.elements_moved == 7 && stats.elements_copied == 0);
+            assert(stats.bytes_allocated == 15 * sizeof(Probe));
+            assert(stats.live_bytes == 8 * sizeof(Probe) && stats.peak_live_bytes == 12 * sizeof(Probe));
+            assert(stats.peak_capacity_bytes == 8 * sizeof(Probe));
+            assert(stats.released_wasted_bytes == 0);
+        }
+        const SimpleVectorStatsSnapshot released = SimpleVectorStats::Snapshot<Probe>();
+        assert(released.live_bytes == 0 && released.deallocations == 4);
+        assert(released.released_wasted_bytes == 3 * sizeof(Probe));
+
+        {
+            SimpleVector<CopiedProbe> v(3);
+            v.Reserve(10);
+            v.ShrinkToFit();
+            const SimpleVectorStatsSnapshot stats = SimpleVectorStats::Snapshot<CopiedProbe>();
+            assert(stats.reallocations == 2 && stats.elements_copied == 6 && stats.elements_moved == 0);
+            assert(stats.released_wasted_bytes == 7 * sizeof(CopiedProbe));
+        }
+
+        SimpleVectorStats::Reset();
+        assert(SimpleVectorStats::Snapshot<Probe>().allocations == 0);
+        size_t exported = 0;
+        bool has_total = false;
+        SimpleVectorStats::Export([&](string_view name, const SimpleVectorStatsSnapshot&) {
+            has_total = has_total || name == "total";
+            ++exported;
+        });
+        assert(has_total && exported >= 3);
+    } else {
+        SimpleVector<Probe> v(100);
+        const SimpleVectorStatsSnapshot stats = SimpleVectorStats::Snapshot();
+        assert(stats.allocations == 0 && SimpleVectorStats::Snapshot<Probe>().bytes_allocated == 0);
+        bool called = false;
+        SimpleVectorStats::Export([&](string_view, const SimpleVectorStatsSnapshot&) {
+            called = true;
+        });
+        assert(!called);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+size_t SumView(ConstSimpleVectorView<int> view) {
+    return static_cast<size_t>(accumulate(view.begin(), view.end(), 0));
+}
+
+void TestSimpleVectorView() {
+    cout << "Test simple vector view" << endl;
+    {
+        SimpleVector<int> v = GenerateVector(10);
+        // неявное приведение вектора без копирования
+        assert(SumView(v) == 55);
+        const SimpleVector<int>& const_v = v;
+        ConstSimpleVectorView<int> all = const_v;
+        assert(all.Data() == v.begin() && all.GetSize() == 10);
+
+        SimpleVectorView<int> mutable_view = v;
+        mutable_view.First(3)[0] = 100;
+        assert(v[0] == 100);
+        v[0] = 1;
+
+        assert(all.First(3) == SimpleVector<int>({1, 2, 3}));
+        assert(all.Last(2) == SimpleVector<int>({9, 10}));
+        assert(all.Subview(4, 2) == SimpleVector<int>({5, 6}));
+        assert(all.Subview(8).GetSize() == 2 && all.Subview(10).IsEmpty());
+        assert(all.Subview(2, 3).Front() == 3 && all.Subview(2, 3).Back() == 5);
+        try {
+            all.Subview(11);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+        try {
+            all.At(10);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+
+        // сравнения представлений и векторов
+        assert(all == v && v == all && mutable_view == all);
+        assert(all.First(3) < all.First(4) && all.Last(1) > all.First(9));
+        assert(all.First(3) != all.Last(3) && all.First(3) <= all.First(3) && all.First(5) >= all.First(4));
+        assert(*all.Find(7) == 7 && all.Find(42) == all.end() && all.Contains(10) && all.Count(3) == 1);
+        assert(SimpleVectorView<int>(v.begin() + 2, v.begin() + 5) == all.Subview(2, 3));
+        assert(SimpleVectorView<int>(v.begin(), 0).IsEmpty());
+    }
+    {
+        // другие непрерывные контейнеры
+        SmallSimpleVector<string, 4> small = {"a", "b", "c"};
+        ConstSimpleVectorView<string> view = small;
+        assert(view.GetSize() == 3 && view.Last(1)[0] == "c" && view.Contains("b"));
+
+        SharedSimpleVector<int> shared;
+        shared.PushBack(1);
+        shared.PushBack(2);
+        ConstSimpleVectorView<int> shared_view = shared;
+        assert(shared_view == SimpleVector<int>({1, 2}));
+
+        SoASimpleVector<int, double> soa = {{1, 0.5}, {2, 1.5}};
+        SimpleVectorView<double> column = soa.Column<1>();
+        column[0] = 2.5;
+        assert(get<1>(soa[0]) == 2.5 && soa.Column<0>() == SimpleVector<int>({1, 2}));
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestAdoptRelease() {
+    cout << "Test adopt and release" << endl;
+    {
+        // чужой буфер из malloc становится вектором без копирования
+        constexpr size_t kFrameSize = 1 << 20;
+        auto* frame = static_cast<uint8_t*>(malloc(kFrameSize));
+        assert(frame != nullptr);
+        memset(frame, 7, kFrameSize);
+        int freed = 0;
+        SimpleVector<uint8_t> v;
+        v.Adopt(frame, kFrameSize, kFrameSize, [&freed](uint8_t* ptr, size_t capacity) {
+            assert(capacity == kFrameSize);
+            free(ptr);
+            ++freed;
+        });
+        assert(v.begin() == frame && v.GetSize() == kFrameSize && v.GetCapacity() == kFrameSize);
+        assert(v.Count(7) == kFrameSize);
+
+        // перемещение передаёт буфер вместе с функцией освобождения
+        SimpleVector<uint8_t> moved(std::move(v));
+        assert(moved.begin() == frame && freed == 0);
+
+        // при росте элементы переезжают в память аллокатора, буфер сразу освобождается
+        moved.PushBack(8);
+        assert(freed == 1 && moved.begin() != frame);
+        assert(moved.GetSize() == kFrameSize + 1 && moved[kFrameSize - 1] == 7 && moved[kFrameSize] == 8);
+    }
+    {
+        // буфер можно отдать и принять обратно
+        SimpleVector<string> v = {"alpha", "beta", "gamma"};
+        v.Reserve(8);
+        const string* data = v.begin();
+        SimpleVectorBuffer<string> buffer = v.Release();
+        assert(v.IsEmpty() && v.GetCapacity() == 0 && v.begin() == nullptr);
+        assert(buffer.data == data && buffer.size == 3 && buffer.capacity == 8);
+
+        SimpleVector<string> adopted;
+        adopted.PushBack("old");
+        adopted.Adopt(buffer.data, buffer.size, buffer.capacity);
+        assert(adopted.begin() == data && adopted.GetSize() == 3 && adopted[2] == "gamma");
+        adopted.PushBack("delta");
+        assert(adopted.begin() == data && adopted.GetCapacity() == 8);
+
+        // освобождение отданного буфера вручную
+        SimpleVectorBuffer<string> released = adopted.Release();
+        allocator<string> alloc;
+        for (size_t i = 0; i < released.size; ++i) {
+            allocator_traits<allocator<string>>::destroy(alloc, released.data + i);
+        }
+        alloc.deallocate(released.data, released.capacity);
+    }
+    {
+        // deleter с одним аргументом; Release возвращает чужой буфер, не вызывая его
+        int deleted = 0;
+        int* numbers = new int[4]{1, 2, 3, 4};
+        SimpleVector<int> v;
+        v.Adopt(numbers, 3, 4, [&deleted](int* ptr) {
+            delete[] ptr;
+            ++deleted;
+        });
+        assert(v == SimpleVector<int>({1, 2, 3}));
+        v.PushBack(5);
+        assert(v.begin() == numbers && v[3] == 5);
+        SimpleVectorBuffer<int> buffer = v.Release();
+        assert(buffer.data == numbers && deleted == 0);
+        delete[] buffer.data;
+
+        int* more = new int[2]{9, 9};
+        {
+            SimpleVector<int> temp;
+            temp.Adopt(more, 2, 2, [&deleted](int* ptr) {
+                delete[] ptr;
+                ++deleted;
+            });
+            SimpleVector<int> other = {1};
+            temp.swap(other);
+            assert(other.begin() == more && deleted == 0);
+        }
+        assert(deleted == 1);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+#if defined(SIMPLE_VECTOR_HAS_CONSTEXPR)
+// Таблица квадратов, построенная при компиляции: вектор живёт только внутри вычисления
+constexpr std::array<int, 8> MakeSquares() {
+    SimpleVector<int> v;
+    for (int i = 0; i < 8; ++i) {
+        v.PushBack(i * i);
+    }
+    std::array<int, 8> table{};
+    std::copy(v.begin(), v.end(), table.begin());
+    return table;
+}
+
+constexpr bool TestConstexprOperations() {
+    SimpleVector<int> v(Reserve(2));
+    v.PushBack(3);
+    v.PushBack(1);
+    v.Insert(v.begin(), 2);
+    v.Insert(v.begin() + 1, size_t{2}, 7);
+    v.Erase(v.begin() + 2);
+    v.Resize(6);
+    v.ResizeDefaultInit(7);
+    SimpleVector<int> copy = v;
+    SimpleVector<int> moved = std::move(copy);
+    moved.PopBack();
+    v.ShrinkToFit();
+    const SimpleVector<int> expected = {2, 7, 3, 1, 0, 0};
+    SimpleVector<string_view> words = {"b", "a"};
+    words.EmplaceBack("c");
+    return moved == expected && v > moved && v.GetCapacity() == 7 && moved.At(1) == 7
+        && words[2] == "c" && SimpleVector<string_view>{"a"} < words;
+}
+
+static_assert(MakeSquares()[7] == 49);
+static_assert(TestConstexprOperations());
+#endif
+
+void TestConstexpr() {
+    cout << "Test constexpr" << endl;
+#if defined(SIMPLE_VECTOR_HAS_CONSTEXPR)
+    constexpr std::array<int, 8> kSquares = MakeSquares();
+    assert(kSquares[3] == 9);
+    // те же функции работают и во время выполнения
+    assert(TestConstexprOperations());
+#endif
+    static_assert(Reserve(5).capacity_to_reserve_ == 5);
+    static_assert(DoublingGrowth::NextCapacity(4, 5, sizeof(int)) == 8);
+    cout << "Done!" << endl << endl;
+}
+
+void TestStaticSimpleVector() {
+    cout << "Test static simple vector" << endl;
+    static_assert(std::is_trivially_copyable_v<StaticSimpleVector<int, 8>>);
+    static_assert(!std::is_trivially_copyable_v<StaticSimpleVector<std::string, 8>>);
+    // поле размера подбирается по N
+    static_assert(sizeof(StaticSimpleVector<uint8_t, 15>) == 16);
+    static_assert(sizeof(StaticSimpleVector<uint16_t, 300>) == 602);
+    static_assert(StaticSimpleVector<int, 5>::GetCapacity() == 5);
+    {
+        StaticSimpleVector<int, 4> v;
+        for (int i = 0; i < 4; ++i) {
+            const bool pushed = v.TryPushBack(i);
+            assert(pushed);
+        }
+        // в заполненный вектор ничего не добавляется
+        const bool overflow_pushed = v.TryPushBack(4);
+        const int* const overflow_emplaced = v.TryEmplaceBack(4);
+        assert(v.IsFull() && !overflow_pushed && overflow_emplaced == nullptr);
+        assert((v == StaticSimpleVector<int, 4>{0, 1, 2, 3}));
+        v.Erase(v.begin() + 1, v.begin() + 3);
+        assert((v == StaticSimpleVector<int, 4>{0, 3}));
+        v.Insert(v.begin() + 1, 7);
+        assert((v == StaticSimpleVector<int, 4>{0, 7, 3}));
+        assert((StaticSimpleVector<int, 4>{1, 2} < StaticSimpleVector<int, 4>{1, 3}));
+        assert(v.Contains(7) && v.Count(3) == 1 && v.Find(5) == v.end());
+
+        StaticSimpleVector<int, 4> copy;
+        std::memcpy(&copy, &v, sizeof(v));
+        assert(copy == v);
+        v.Resize(4);
+        assert(v[3] == 0 && v.At(2) == 3);
+        try {
+            v.At(4);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+        ConstSimpleVectorView<int> view = v;
+        assert(view.GetSize() == 4 && view[1] == 7);
+    }
+    {
+        StaticSimpleVector<std::string, 3> a{"a", "b"};
+        StaticSimpleVector<std::string, 3> b{"c"};
+        a.swap(b);
+        assert(a.GetSize() == 1 && a[0] == "c" && b.GetSize() == 2 && b[1] == "b");
+        a = b;
+        assert(a == b);
+        a.EmplaceBack(3, 'x');
+        assert(a.IsFull());
+        const auto after_erased = a.Erase(a.begin());
+        assert(after_erased == a.begin() && a[0] == "b");
+        StaticSimpleVector<std::string, 3> moved(std::move(a));
+        assert(moved.GetSize() == 2 && moved[1] == "xxx");
+        b = std::move(moved);
+        assert(b.GetSize() == 2 && b[0] == "b");
+        b.PopBack();
+        b.Clear();
+        assert(b.IsEmpty());
+    }
+    Counted::Reset();
+    {
+        StaticSimpleVector<Counted, 4> v;
+        v.PushBack(Counted(1));
+        v.PushBack(Counted(2));
+        StaticSimpleVector<Counted, 4> copy = v;
+        v.Erase(v.begin());
+        assert(Counted::alive == 3 && v[0].value == 2 && copy[1].value == 2);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestSegmentedSimpleVector() {
+    cout << "Test segmented simple vector" << endl;
+    static_assert(SegmentedSimpleVector<int>::kSegmentSize == 16384);
+    {
+        SegmentedSimpleVector<int, 4> v;
+        v.PushBack(0);
+        int* first = &v[0];
+        for (int i = 1; i < 10; ++i) {
+            v.PushBack(i);
+        }
+        // рост добавляет сегменты и не переносит элементы
+        assert(&v[0] == first && v.GetSegmentCount() == 3 && v.GetCapacity() == 12);
+        assert(v.GetSize() == 10 && v.At(9) == 9 && v.Back() == 9);
+        assert(std::accumulate(v.begin(), v.end(), 0) == 45);
+        assert(v.end() - v.begin() == 10 && *(v.begin() + 5) == 5 && v.begin()[6] == 6);
+        auto [seg_first, seg_last] = v.GetSegment(2);
+        assert(seg_last - seg_first == 2 && *seg_first == 8);
+
+        std::sort(v.begin(), v.end(), std::greater<>());
+        assert(v.Front() == 9 && v[9] == 0);
+        v.Insert(v.begin() + 2, 100);
+        assert(v.GetSize() == 11 && v[2] == 100 && v[3] == 7 && v[10] == 0);
+        v.Erase(v.begin(), v.begin() + 3);
+        assert(v.GetSize() == 8 && v[0] == 7 && v[7] == 0);
+
+        SegmentedSimpleVector<int, 4> copy = v;
+        assert(copy == v && &copy[0] != &v[0]);
+        copy.PushBack(-1);
+        assert(v < copy && v != copy);
+        v.Resize(2);
+        v.ShrinkToFit();
+        assert(v.GetSegmentCount() == 1 && (v == SegmentedSimpleVector<int, 4>{7, 6}));
+        v.Resize(6);
+        assert(v.GetSegmentCount() == 2 && v[5] == 0);
+        try {
+            v.At(6);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+    }
+    {
+        SegmentedSimpleVector<std::string, 2> a{"a", "b", "c"};
+        SegmentedSimpleVector<std::string, 2> b(std::move(a));
+        assert(a.IsEmpty() && b.GetSize() == 3 && b[2] == "c");
+        a = b;
+        a.EmplaceBack(2, 'd');
+        a.swap(b);
+        assert(a.GetSize() == 3 && b.GetSize() == 4 && b[3] == "dd");
+        b.PopBack();
+        assert(a == b);
+    }
+    {
+        ThreadPool pool(3);
+        SegmentedSimpleVector<int, 1024> v(10000, 1);
+        ParallelForEach(v, [](int& value) {
+            value *= 2;
+        }, pool);
+        std::atomic<long> total = 0;
+        std::atomic<int> segments = 0;
+        ParallelForEachSegment(std::as_const(v), [&](const int* first, const int* last) {
+            total += std::accumulate(first, last, 0L);
+            ++segments;
+        }, pool);
+        assert(total == 20000 && segments == 10);
+    }
+    Counted::Reset();
+    {
+        SegmentedSimpleVector<Counted, 2> v;
+        for (int i = 0; i < 5; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Erase(v.begin() + 1);
+        assert(Counted::alive == 4 && v[1].value == 2);
+    }
+    assert(Counted::alive == 0);
+    {
+        // полиморфный аллокатор не распространяется при присваивании: вектор сохраняет свой ресурс
+        using PmrSegmented = SegmentedSimpleVector<int, 4, std::pmr::polymorphic_allocator<int>>;
+        std::pmr::unsynchronized_pool_resource first_pool;
+        std::pmr::unsynchronized_pool_resource second_pool;
+        PmrSegmented a({1, 2, 3, 4, 5}, &first_pool);
+        PmrSegmented b(&first_pool);
+        b = a;
+        assert(b == a && b.GetAllocator().resource() == &first_pool);
+        PmrSegmented c({9}, &second_pool);
+        c = a;
+        assert(c == a && c.GetAllocator().resource() == &second_pool);
+        // между равными ресурсами сегменты передаются целиком
+        const int* data = &a[0];
+        b = std::move(a);
+        assert(&b[0] == data && a.IsEmpty() && b.GetSize() == 5);
+        // между разными — элементы перемещаются по одному в сегменты своего ресурса
+        c = std::move(b);
+        assert(&c[0] != data && c.GetSize() == 5 && c[4] == 5 && b.IsEmpty());
+        assert(c.GetAllocator().resource() == &second_pool);
+        PmrSegmented moved(std::move(c), &first_pool);
+        assert(moved.GetSize() == 5 && moved[0] == 1 && c.IsEmpty());
+    }
+    cout << "Done!" << endl << endl;
+}
+
+template <typename SearchPolicy>
+void TestFlatSetWith() {
+    FlatSet<int, std::less<int>, SearchPolicy> set{5, 1, 3, 3, 9};
+    assert(set.GetSize() == 4 && (set.Keys() == SimpleVector<int>{1, 3, 5, 9}));
+    assert(set.Contains(3) && !set.Contains(4) && set.Count(9) == 1);
+    assert(*set.LowerBound(4) == 5 && set.LowerBound(10) == set.end());
+    const bool inserted = set.Insert(4).second;
+    const bool inserted_again = set.Insert(4).second;
+    assert(inserted && !inserted_again);
+    const std::vector<int> more{0, 2, 3, 10, 10};
+    set.InsertSorted(more.begin(), more.end());
+    assert((set.Keys() == SimpleVector<int>{0, 1, 2, 3, 4, 5, 9, 10}));
+    const size_t erased = set.Erase(5);
+    const size_t erased_again = set.Erase(5);
+    assert(erased == 1 && erased_again == 0);
+    set.Erase(set.begin(), set.begin() + 2);
+    assert((set.Keys() == SimpleVector<int>{2, 3, 4, 9, 10}));
+    // поиск сверяется с std::lower_bound на всех позициях
+    for (int size = 0; size < 40; ++size) {
+        std::vector<int> keys(static_cast<size_t>(size));
+        std::iota(keys.begin(), keys.end(), 0);
+        std::transform(keys.begin(), keys.end(), keys.begin(), [](int k) {
+            return k * 2;
+        });
+        set.BuildFrom(keys.rbegin(), keys.rend());
+        for (int key = -1; key <= size * 2; ++key) {
+            auto expected = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+            assert(set.LowerBound(key) - set.begin() == expected);
+            assert(set.Contains(key) == (key >= 0 && key < size * 2 && key % 2 == 0));
+        }
+    }
+}
+
+template <typename SearchPolicy>
+void TestFlatMapWith() {
+    FlatMap<std::string, int, std::less<std::string>, SearchPolicy> map{{"b", 2}, {"a", 1}, {"b", 20}, {"c", 3}};
+    assert(map.GetSize() == 3 && map.At("b") == 2 && *map.Find("c") == 3 && map.Find("d") == nullptr);
+    assert((map.Values() == SimpleVector<int>{1, 2, 3}));
+    const bool inserted = map.Insert("a", 10).second;
+    assert(!inserted && map.At("a") == 1);
+    const auto assigned = map.InsertOrAssign("a", 10);
+    assert(assigned.first == map.Find("a") && !assigned.second && map.At("a") == 10);
+    map["d"] += 4;
+    assert(map.GetSize() == 4 && map.At("d") == 4 && map.LowerBound("bb") == 2);
+    const std::vector<std::pair<std::string, int>> more{{"a", 0}, {"aa", 5}, {"e", 6}, {"e", 7}};
+    map.InsertSorted(more.begin(), more.end());
+    assert(map.GetSize() == 6 && map.At("aa") == 5 && map.At("e") == 6 && map.At("a") == 10);
+    assert(map.Keys()[1] == "aa" && map.Values()[1] == 5);
+    const size_t erased = map.Erase("b");
+    const size_t erased_again = map.Erase("b");
+    assert(erased == 1 && !map.Contains("b") && erased_again == 0);
+    map.EraseRange(0, 2);
+    assert(map.GetSize() == 3 && map.Keys()[0] == "c" && map.Values()[0] == 3);
+    try {
+        map.At("zz");
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+    auto copy = map;
+    assert(copy == map);
+    copy.Clear();
+    assert(copy.IsEmpty() && !copy.Contains("c") && copy != map);
+}
+
+void TestFlatMapThrowingCopy() {
+    FlatMap<std::string, ThrowingCopyProbe> map;
+    std::vector<std::pair<std::string, ThrowingCopyProbe>> old;
+    old.emplace_back("a", ThrowingCopyProbe(1));
+    old.emplace_back("b", ThrowingCopyProbe(2));
+    old.emplace_back("c", ThrowingCopyProbe(3));
+    ThrowingCopyProbe::copies_left = 0;
+    map.InsertSorted(old.begin(), old.end());
+    std::vector<std::pair<std::string, ThrowingCopyProbe>> more;
+    more.emplace_back("aa", ThrowingCopyProbe(10));
+    more.emplace_back("bb", ThrowingCopyProbe(20));
+    const int alive = ThrowingCopyProbe::alive;
+    // копия второго значения бросает: карта не меняется
+    ThrowingCopyProbe::copies_left = 2;
+    try {
+        map.InsertSorted(more.begin(), more.end());
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    assert(ThrowingCopyProbe::alive == alive);
+    assert((map.Keys() == SimpleVector<std::string>{"a", "b", "c"}));
+    assert(map.Find("a") != nullptr && *map.At("a").value == 1 && *map.At("c").value == 3);
+    ThrowingCopyProbe::copies_left = 0;
+    map.InsertSorted(more.begin(), more.end());
+    assert((map.Keys() == SimpleVector<std::string>{"a", "aa", "b", "bb", "c"}));
+    assert(*map.At("bb").value == 20 && *map.At("b").value == 2);
+}
+
+void TestFlatMap() {
+    cout << "Test flat set and map" << endl;
+    TestFlatSetWith<BranchlessSearch>();
+    TestFlatSetWith<EytzingerSearch>();
+    TestFlatMapWith<BranchlessSearch>();
+    TestFlatMapWith<EytzingerSearch>();
+    TestFlatMapThrowingCopy();
+    cout << "Done!" << endl << endl;
+}
+
+#if defined(SIMPLE_VECTOR_HAS_COROUTINES)
+// Пакет «сырых» данных: декодирование прибавляет 1000 к каждому значению
+struct IntBatch {
+    std::vector<int> raw;
+    bool fail = false;
+
+    size_t GetSize() const {
+        return raw.size();
+    }
+
+    void DecodeInto(int* dest) const {
+        if (fail) {
+            throw std::runtime_error("corrupted batch");
+        }
+        for (int value : raw) {
+            *dest++ = value + 1000;
+        }
+    }
+};
+
+// Источник из total чисел; пакет с номером fail_batch не декодируется
+class CountingSource {
+public:
+    CountingSource(int total, int fail_batch = -1)
+        : total_(total), fail_batch_(fail_batch) {
+    }
+
+    IntBatch Read(size_t max_count) {
+        std::lock_guard lock(mutex_);
+        IntBatch batch;
+        while (next_ < total_ && batch.raw.size() < max_count) {
+            batch.raw.push_back(next_++);
+        }
+        batch.fail = batch_index_++ == fail_batch_;
+        return batch;
+    }
+
+    size_t SizeHint() const {
+        std::lock_guard lock(mutex_);
+        return static_cast<size_t>(total_ - next_);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    int total_;
+    int next_ = 0;
+    int fail_batch_;
+    int batch_index_ = 0;
+};
+
+// Готовый сразу пакет: чтение синхронное
+struct ReadyBatch {
+    IntBatch batch;
+
+    bool await_ready() const noexcept {
+        return true;
+    }
+
+    void await_suspend(std::coroutine_handle<>) const noexcept {
+    }
+
+    IntBatch await_resume() {
+        return std::move(batch);
+    }
+};
+
+struct ImmediateSource : CountingSource {
+    using CountingSource::CountingSource;
+
+    ReadyBatch Fetch(size_t max_count) {
+        return ReadyBatch{Read(max_count)};
+    }
+};
+
+// Чтение в потоке пула
+struct PoolSource : CountingSource {
+    PoolSource(ThreadPool& pool, int total, int fail_batch = -1)
+        : CountingSource(total, fail_batch), pool_(pool) {
+    }
+
+    PoolResult<IntBatch> Fetch(size_t max_count) {
+        return RunOnPool(pool_, [this, max_count] {
+            return Read(max_count);
+        });
+    }
+
+private:
+    ThreadPool& pool_;
+};
+
+template <typename Source>
+Task<size_t> LoadTwice(SimpleVector<int>& v, Source& first, Source& second) {
+    size_t count = co_await AppendFrom(v, first, 3);
+    count += co_await AppendFrom(v, second, 4);
+    co_return count;
+}
+#endif
+
+void TestAsyncAppend() {
+    cout << "Test async append" << endl;
+#if defined(SIMPLE_VECTOR_HAS_COROUTINES)
+    {
+        SimpleVector<int> v{-1};
+        ImmediateSource source(10);
+        const size_t appended = SyncWait(AppendFrom(v, source, 4));
+        assert(appended == 10);
+        assert(v.GetSize() == 11 && v[0] == -1 && v[1] == 1000 && v[10] == 1009);
+        // по подсказке размера память зарезервирована заранее одним выделением
+        assert(v.GetCapacity() == 11);
+    }
+    {
+        ThreadPool pool(2);
+        SimpleVector<int> v;
+        PoolSource first(pool, 7);
+        PoolSource second(pool, 9);
+        const size_t loaded = SyncWait(LoadTwice(v, first, second));
+        assert(loaded == 16);
+        assert(v.GetSize() == 16 && v[6] == 1006 && v[7] == 1000 && v[15] == 1008);
+
+        PoolSource failing(pool, 20, 2);
+        try {
+            SyncWait(AppendFrom(v, failing, 5));
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        // два пакета дописаны, испорченный удалён
+        assert(v.GetSize() == 26 && v[25] == 1009);
+    }
+    {
+        ImmediateSource empty(0);
+        SimpleVector<int> v;
+        const size_t appended = SyncWait(AppendFrom(v, empty));
+        assert(appended == 0 && v.IsEmpty());
+    }
+#endif
+    cout << "Done!" << endl << endl;
 }
 
 int main() {
@@ -332,5 +2575,35 @@ int main() {
     TestNoncopiablePushBack();
     TestNoncopiableInsert();
     TestNoncopiableErase();
+    TestRawStorage();
+    TestPolymorphicAllocator();
+    TestArena();
+    TestSmallSimpleVector();
+    TestTriviallyRelocatable();
+    TestNoexceptMove();
+    TestGrowthPolicy();
+    TestEmplace();
+    TestRangeOperations();
+    TestShrinkToFit();
+    TestDefaultInit();
+    TestSimdKernels();
+    TestParallelAlgorithms();
+    TestWorkStealing();
+    TestConcurrentSimpleVector();
+    TestSharedSimpleVector();
+    TestMappedSimpleVector();
+    TestSerialization();
+    TestLargePageAllocator();
+    TestAlignedStorage();
+    TestSoASimpleVector();
+    TestStats();
+    TestSimpleVectorView();
+    TestAdoptRelease();
+    TestConstexpr();
+    TestStaticSimpleVector();
+    TestSegmentedSimpleVector();
+    TestFlatMap();
+    TestAsyncAppend();
+    cout << "All tests passed successfully!" << endl;
     return 0;
 }
\ No newline at end of file
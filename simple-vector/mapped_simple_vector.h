@@ -0,0 +1,398 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "growth_policy.h"
+
+// Вектор тривиально копируемых элементов, хранящихся в отображённом в память файле (POSIX).
+// Открытие не читает и не разбирает файл: страницы подгружаются при первом обращении.
+// Файл начинается с заголовка на kMappedHeaderSize байт (сигнатура, размер элемента,
+// количество элементов), за ним идут элементы; длина файла задаёт вместимость.
+// Рост — ftruncate и mremap (на Linux; на других системах — повторный mmap).
+// Ошибки системных вызовов выбрасываются как std::system_error,
+// несовместимый формат файла — как std::runtime_error
+
+inline constexpr size_t kMappedHeaderSize = 64;
+
+enum class MappedOpenMode {
+    kOpenOrCreate,  // открыть файл или создать пустой
+    kTruncate,      // создать пустой файл, затерев прежнее содержимое
+    kOpenExisting,  // открыть существующий файл
+};
+
+// Подсказки ядру о порядке доступа (madvise)
+enum class MappedAdvice {
+    kNormal,
+    kSequential,
+    kRandom,
+    kWillNeed,
+    kDontNeed,
+};
+
+namespace simple_vector_detail {
+
+struct MappedHeader {
+    char magic[8];
+    uint64_t element_size;
+    uint64_t size;
+    uint64_t reserved[5];
+};
+
+static_assert(sizeof(MappedHeader) == kMappedHeaderSize);
+
+inline constexpr char kMappedMagic[8] = {'S', 'V', 'M', 'A', 'P', '\0', '\0', '\1'};
+
+[[noreturn]] inline void ThrowSystemError(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace simple_vector_detail
+
+template <typename Type, typename GrowthPolicy = PageRoundedGrowth<DoublingGrowth>>
+class MappedSimpleVector {
+    static_assert(std::is_trivially_copyable_v<Type>, "MappedSimpleVector requires a trivially copyable type");
+    static_assert(alignof(Type) <= kMappedHeaderSize, "Element alignment must not exceed the header size");
+
+    using Header = simple_vector_detail::MappedHeader;
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    // Открывает или создаёт файл path и отображает его в память
+    explicit MappedSimpleVector(const std::string& path, MappedOpenMode mode = MappedOpenMode::kOpenOrCreate) {
+        int flags = O_RDWR | O_CLOEXEC;
+        if (mode == MappedOpenMode::kOpenOrCreate) {
+            flags |= O_CREAT;
+        } else if (mode == MappedOpenMode::kTruncate) {
+            flags |= O_CREAT | O_TRUNC;
+        }
+        fd_ = ::open(path.c_str(), flags, 0644);
+        if (fd_ < 0) {
+            simple_vector_detail::ThrowSystemError("open");
+        }
+        try {
+            Open();
+        } catch (...) {
+            Unmap();
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    MappedSimpleVector(const MappedSimpleVector&) = delete;
+    MappedSimpleVector& operator=(const MappedSimpleVector&) = delete;
+
+    MappedSimpleVector(MappedSimpleVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1)),
+          base_(std::exchange(other.base_, nullptr)),
+          mapped_bytes_(std::exchange(other.mapped_bytes_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    MappedSimpleVector& operator=(MappedSimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            base_ = std::exchange(rhs.base_, nullptr);
+            mapped_bytes_ = std::exchange(rhs.mapped_bytes_, 0);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
+        return *this;
+    }
+
+    // Снимает отображение и закрывает файл. Изменения остаются в файле:
+    // ядро запишет их на диск само, для немедленной записи служит Flush
+    ~MappedSimpleVector() {
+        Close();
+    }
+
+    size_t GetSize() const noexcept {
+        return base_ != nullptr ? static_cast<size_t>(GetHeader()->size) : 0;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < GetSize());
+        return Data()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return Data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("out of range");
+        }
+        return Data()[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("out of range");
+        }
+        return Data()[index];
+    }
+
+    // Увеличивает файл так, чтобы в нём поместилось new_capacity элементов
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Remap(new_capacity);
+        }
+    }
+
+    // Уменьшает файл до текущего количества элементов
+    void ShrinkToFit() {
+        if (capacity_ > GetSize()) {
+            Remap(GetSize());
+        }
+    }
+
+    void PushBack(const Type& item) {
+        const size_t size = GetSize();
+        if (size == capacity_) {
+            // item может лежать в отображении, которое сейчас переедет
+            const Type copy = item;
+            Remap(NextCapacity(size + 1));
+            Data()[size] = copy;
+        } else {
+            Data()[size] = item;
+        }
+        SetSize(size + 1);
+    }
+
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        SetSize(GetSize() - 1);
+    }
+
+    // Новые элементы инициализируются значением по умолчанию Type{}
+    void Resize(size_t new_size) {
+        const size_t size = GetSize();
+        if (new_size > capacity_) {
+            Remap(NextCapacity(new_size));
+        }
+        if (new_size > size) {
+            std::fill(Data() + size, Data() + new_size, Type{});
+        }
+        SetSize(new_size);
+    }
+
+    // Обнуляет размер, не изменяя длину файла
+    void Clear() noexcept {
+        if (base_ != nullptr) {
+            SetSize(0);
+        }
+    }
+
+    // Синхронно (или асинхронно, если async) записывает изменённые страницы в файл
+    void Flush(bool async = false) {
+        if (base_ != nullptr && ::msync(base_, mapped_bytes_, async ? MS_ASYNC : MS_SYNC) != 0) {
+            simple_vector_detail::ThrowSystemError("msync");
+        }
+    }
+
+    // Сообщает ядру ожидаемый порядок доступа к элементам
+    void Advise(MappedAdvice advice) {
+        if (base_ == nullptr) {
+            return;
+        }
+        int native = MADV_NORMAL;
+        switch (advice) {
+        case MappedAdvice::kNormal:
+            native = MADV_NORMAL;
+            break;
+        case MappedAdvice::kSequential:
+            native = MADV_SEQUENTIAL;
+            break;
+        case MappedAdvice::kRandom:
+            native = MADV_RANDOM;
+            break;
+        case MappedAdvice::kWillNeed:
+            native = MADV_WILLNEED;
+            break;
+        case MappedAdvice::kDontNeed:
+            native = MADV_DONTNEED;
+            break;
+        }
+        if (::madvise(base_, mapped_bytes_, native) != 0) {
+            simple_vector_detail::ThrowSystemError("madvise");
+        }
+    }
+
+    Iterator begin() noexcept {
+        return Data();
+    }
+
+    Iterator end() noexcept {
+        return Data() + GetSize();
+    }
+
+    ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator end() const noexcept {
+        return Data() + GetSize();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    Header* GetHeader() const noexcept {
+        return static_cast<Header*>(base_);
+    }
+
+    Type* Data() const noexcept {
+        return base_ != nullptr ? reinterpret_cast<Type*>(static_cast<char*>(base_) + kMappedHeaderSize) : nullptr;
+    }
+
+    void SetSize(size_t size) noexcept {
+        GetHeader()->size = size;
+    }
+
+    static size_t MaxCapacity() noexcept {
+        return (static_cast<size_t>(std::numeric_limits<off_t>::max()) - kMappedHeaderSize) / sizeof(Type);
+    }
+
+    size_t NextCapacity(size_t required) const {
+        if (required > MaxCapacity()) {
+            throw std::length_error("MappedSimpleVector is too long");
+        }
+        return std::min(GrowthPolicy::NextCapacity(capacity_, required, sizeof(Type)), MaxCapacity());
+    }
+
+    static size_t FileBytes(size_t capacity) noexcept {
+        return kMappedHeaderSize + capacity * sizeof(Type);
+    }
+
+    void Open() {
+        struct stat info {};
+        if (::fstat(fd_, &info) != 0) {
+            simple_vector_detail::ThrowSystemError("fstat");
+        }
+        const auto file_bytes = static_cast<size_t>(info.st_size);
+        if (file_bytes == 0) {
+            // новый файл: только заголовок
+            if (::ftruncate(fd_, static_cast<off_t>(kMappedHeaderSize)) != 0) {
+                simple_vector_detail::ThrowSystemError("ftruncate");
+            }
+            Map(kMappedHeaderSize);
+            Header* header = GetHeader();
+            std::memcpy(header->magic, simple_vector_detail::kMappedMagic, sizeof(header->magic));
+            header->element_size = sizeof(Type);
+            header->size = 0;
+            capacity_ = 0;
+            return;
+        }
+        if (file_bytes < kMappedHeaderSize) {
+            throw std::runtime_error("MappedSimpleVector: file is too short");
+        }
+        Map(file_bytes);
+        const Header* header = GetHeader();
+        if (std::memcmp(header->magic, simple_vector_detail::kMappedMagic, sizeof(header->magic)) != 0) {
+            throw std::runtime_error("MappedSimpleVector: bad file signature");
+        }
+        if (header->element_size != sizeof(Type)) {
+            throw std::runtime_error("MappedSimpleVector: element size mismatch");
+        }
+        capacity_ = (file_bytes - kMappedHeaderSize) / sizeof(Type);
+        if (header->size > capacity_) {
+            throw std::runtime_error("MappedSimpleVector: file is truncated");
+        }
+    }
+
+    void Map(size_t bytes) {
+        void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base == MAP_FAILED) {
+            simple_vector_detail::ThrowSystemError("mmap");
+        }
+        base_ = base;
+        mapped_bytes_ = bytes;
+    }
+
+    // Меняет длину файла и отображения под new_capacity элементов.
+    // Адрес отображения может измениться: указатели и итераторы становятся недействительными
+    void Remap(size_t new_capacity) {
+        const size_t new_bytes = FileBytes(new_capacity);
+        const bool shrinking = new_bytes < mapped_bytes_;
+        // при росте файл удлиняется до отображения, при уменьшении — укорачивается после
+        if (!shrinking && ::ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0) {
+            simple_vector_detail::ThrowSystemError("ftruncate");
+        }
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+        void* base = ::mremap(base_, mapped_bytes_, new_bytes, MREMAP_MAYMOVE);
+        if (base == MAP_FAILED) {
+            simple_vector_detail::ThrowSystemError("mremap");
+        }
+        base_ = base;
+        mapped_bytes_ = new_bytes;
+#else
+        void* base = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base == MAP_FAILED) {
+            simple_vector_detail::ThrowSystemError("mmap");
+        }
+        Unmap();
+        base_ = base;
+        mapped_bytes_ = new_bytes;
+#endif
+        if (shrinking && ::ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0) {
+            simple_vector_detail::ThrowSystemError("ftruncate");
+        }
+        capacity_ = new_capacity;
+    }
+
+    void Unmap() noexcept {
+        if (base_ != nullptr) {
+            ::munmap(base_, mapped_bytes_);
+            base_ = nullptr;
+            mapped_bytes_ = 0;
+        }
+    }
+
+    void Close() noexcept {
+        Unmap();
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        capacity_ = 0;
+    }
+
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    size_t capacity_ = 0;
+};
@@ -0,0 +1,597 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "segmented_simple_vector.h"
+#include "simple_vector.h"
+
+// Параллельные алгоритмы над SimpleVector. Диапазон рекурсивно делится пополам, пока куски
+// больше grain элементов; одна половина ставится в очередь потока, другая обрабатывается сразу.
+// Простаивающие потоки крадут самые крупные оставшиеся половины, так что неравномерная
+// по стоимости работа распределяется сама. Границы кусков выровнены по строкам кэша,
+// так что потоки не пишут в одну строку (нет false sharing). Диапазоны не длиннее grain
+// обрабатываются последовательно. Вызывающий поток тоже работает, пока ждёт.
+// Исключение из пользовательской функции пробрасывается после завершения всех кусков
+
+inline constexpr size_t kCacheLineSize = 64;
+
+// Куски не длиннее этого числа элементов не делятся дальше
+inline constexpr size_t kDefaultGrainSize = 16384;
+
+namespace simple_vector_detail {
+
+// Двусторонняя очередь Чейза — Лева (Chase, Lev; Lê и др. для модели памяти C11).
+// Владелец кладёт и забирает задачи с нижнего конца без блокировок,
+// остальные потоки крадут с верхнего. Задачи хранятся как указатели
+template <typename Task>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 256)
+        : buffer_(new Buffer(capacity)) {
+        retired_.emplace_back(buffer_.load(std::memory_order_relaxed));
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Кладёт задачу на нижний конец. Вызывается только владельцем
+    void Push(Task* task) {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(buffer->capacity) - 1) {
+            buffer = Grow(buffer, top, bottom);
+        }
+        buffer->Put(bottom, task);
+        // release-запись вместо отдельного барьера: вор, увидевший bottom, увидит и задачу
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    // Забирает последнюю положенную задачу либо возвращает nullptr. Вызывается только владельцем
+    Task* Pop() noexcept {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Task* task = buffer->Get(bottom);
+        if (top == bottom) {
+            // последняя задача: соревнуемся с ворами
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Крадёт самую старую задачу. Возвращает nullptr, если очередь пуста или кража не удалась
+    Task* Steal() noexcept {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Task* task = buffer_.load(std::memory_order_acquire)->Get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return task;
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(size_t size)
+            : capacity(size), mask(size - 1), slots(new std::atomic<Task*>[size]) {
+        }
+
+        void Put(int64_t index, Task* task) noexcept {
+            slots[static_cast<size_t>(index) & mask].store(task, std::memory_order_relaxed);
+        }
+
+        Task* Get(int64_t index) const noexcept {
+            return slots[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+    };
+
+    // Старые буферы не освобождаются до разрушения очереди: вор мог успеть прочитать указатель
+    Buffer* Grow(Buffer* old, int64_t top, int64_t bottom) {
+        auto grown = std::make_unique<Buffer>(old->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            grown->Put(i, old->Get(i));
+        }
+        Buffer* result = grown.get();
+        retired_.push_back(std::move(grown));
+        buffer_.store(result, std::memory_order_release);
+        return result;
+    }
+
+    alignas(kCacheLineSize) std::atomic<int64_t> top_ = 0;
+    alignas(kCacheLineSize) std::atomic<int64_t> bottom_ = 0;
+    std::atomic<Buffer*> buffer_;
+    std::vector<std::unique_ptr<Buffer>> retired_;
+};
+
+} // namespace simple_vector_detail
+
+// Пул с фиксированным числом потоков и планированием с кражей задач: у каждого потока
+// своя очередь Чейза — Лева, задачи из потоков вне пула попадают в общую очередь.
+// Поток без работы крадёт задачи у случайно выбранных соседей
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // Создаёт thread_count рабочих потоков (по умолчанию — по числу аппаратных потоков минус вызывающий)
+    explicit ThreadPool(size_t thread_count = DefaultThreadCount()) {
+        workers_.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        // потоки запускаются, когда все очереди уже созданы: воры обращаются к любой
+        for (size_t i = 0; i < thread_count; ++i) {
+            workers_[i]->thread = std::thread([this, i] {
+                WorkerLoop(i);
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Дожидается выполнения поставленных задач и останавливает потоки
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        task_ready_.notify_all();
+        for (auto& worker : workers_) {
+            worker->thread.join();
+        }
+    }
+
+    static size_t DefaultThreadCount() noexcept {
+        const unsigned hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 1;
+    }
+
+    // Возвращает количество рабочих потоков
+    size_t GetThreadCount() const noexcept {
+        return workers_.size();
+    }
+
+    // Ставит задачу в очередь текущего потока пула либо, из чужого потока, в общую очередь
+    void Submit(Task task) {
+        auto owned = std::make_unique<Task>(std::move(task));
+        // счётчик растёт до публикации задачи, иначе её успеют взять раньше
+        queued_.fetch_add(1, std::memory_order_seq_cst);
+        const ThreadSlot& slot = CurrentThread();
+        try {
+            if (slot.pool == this) {
+                workers_[slot.index]->deque.Push(owned.get());
+            } else {
+                std::lock_guard lock(injection_mutex_);
+                injected_.push_back(owned.get());
+            }
+        } catch (...) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            throw;
+        }
+        owned.release();
+        if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard lock(mutex_);
+            task_ready_.notify_one();
+        }
+    }
+
+    // Выполняет одну задачу в текущем потоке: свою, из общей очереди или украденную.
+    // Возвращает false, если задач не нашлось
+    bool RunPendingTask() {
+        std::unique_ptr<Task> task(TakeTask());
+        if (!task) {
+            return false;
+        }
+        (*task)();
+        return true;
+    }
+
+private:
+    struct alignas(kCacheLineSize) Worker {
+        simple_vector_detail::WorkStealingDeque<Task> deque;
+        std::thread thread;
+
+        // поток уже остановлен, оставшиеся задачи никто не выполнит
+        ~Worker() {
+            while (Task* task = deque.Pop()) {
+                delete task;
+            }
+        }
+    };
+
+    struct ThreadSlot {
+        ThreadPool* pool = nullptr;
+        size_t index = 0;
+        uint64_t random_state = 0x9E3779B97F4A7C15ull;
+    };
+
+    static ThreadSlot& CurrentThread() noexcept {
+        thread_local ThreadSlot slot;
+        return slot;
+    }
+
+    static uint64_t NextRandom(ThreadSlot& slot) noexcept {
+        // xorshift64
+        slot.random_state ^= slot.random_state << 13;
+        slot.random_state ^= slot.random_state >> 7;
+        slot.random_state ^= slot.random_state << 17;
+        return slot.random_state;
+    }
+
+    Task* TakeTask() {
+        ThreadSlot& slot = CurrentThread();
+        Task* task = nullptr;
+        if (slot.pool == this) {
+            task = workers_[slot.index]->deque.Pop();
+        }
+        if (task == nullptr) {
+            std::lock_guard lock(injection_mutex_);
+            if (!injected_.empty()) {
+                task = injected_.front();
+                injected_.pop_front();
+            }
+        }
+        // по одной попытке на каждого соседа, начиная со случайного
+        const size_t count = workers_.size();
+        if (task == nullptr && count > 0) {
+            const size_t start = static_cast<size_t>(NextRandom(slot) % count);
+            for (size_t i = 0; i < count && task == nullptr; ++i) {
+                const size_t victim = (start + i) % count;
+                if (slot.pool != this || victim != slot.index) {
+                    task = workers_[victim]->deque.Steal();
+                }
+            }
+        }
+        if (task != nullptr) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    void WorkerLoop(size_t index) {
+        ThreadSlot& slot = CurrentThread();
+        slot.pool = this;
+        slot.index = index;
+        slot.random_state += index * 0x9E3779B97F4A7C15ull;
+        for (;;) {
+            if (RunPendingTask()) {
+                continue;
+            }
+            std::unique_lock lock(mutex_);
+            sleeping_.fetch_add(1, std::memory_order_seq_cst);
+            task_ready_.wait(lock, [this] {
+                return stopping_ || queued_.load(std::memory_order_seq_cst) > 0;
+            });
+            sleeping_.fetch_sub(1, std::memory_order_relaxed);
+            if (stopping_ && queued_.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex injection_mutex_;
+    std::deque<Task*> injected_;
+    // число задач в очередях и число спящих потоков: по ним решается, будить ли поток
+    std::atomic<size_t> queued_ = 0;
+    std::atomic<size_t> sleeping_ = 0;
+    std::mutex mutex_;
+    std::condition_variable task_ready_;
+    bool stopping_ = false;
+};
+
+// Пул потоков по умолчанию, общий для всей программы
+inline ThreadPool& DefaultThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+namespace simple_vector_detail {
+
+// Группа задач, завершения которых ждёт вызывающий поток.
+// Запоминает первое исключение, брошенное задачами
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) noexcept
+        : pool_(pool) {
+    }
+
+    template <typename Func>
+    void Run(Func func) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.Submit([this, func = std::move(func)]() mutable {
+            Execute(func);
+            Finish();
+        });
+    }
+
+    // Выполняет задачу в текущем потоке
+    template <typename Func>
+    void RunHere(Func& func) {
+        Execute(func);
+    }
+
+    // Ждёт завершения всех задач, помогая пулу, и пробрасывает исключение
+    void Wait() {
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            if (!pool_.RunPendingTask()) {
+                std::unique_lock lock(mutex_);
+                done_.wait(lock, [this] {
+                    return pending_.load(std::memory_order_acquire) == 0;
+                });
+            }
+        }
+        // дожидаемся, пока последняя задача отпустит мьютекс в Finish
+        std::lock_guard lock(mutex_);
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    template <typename Func>
+    void Execute(Func& func) noexcept {
+        try {
+            func();
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+
+    void Finish() {
+        // уведомление под мьютексом: ожидающий поток не разрушит группу раньше времени
+        std::lock_guard lock(mutex_);
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            done_.notify_all();
+        }
+    }
+
+    ThreadPool& pool_;
+    std::atomic<size_t> pending_ = 0;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::exception_ptr error_;
+};
+
+// Сдвигает границу куска index вперёд до адреса, кратного alignment (по умолчанию — строки кэша)
+template <typename Type>
+size_t AlignChunkBoundary(const Type* base, size_t index, size_t size, size_t alignment = kCacheLineSize) noexcept {
+    const auto base_address = reinterpret_cast<uintptr_t>(base);
+    const uintptr_t address = base_address + index * sizeof(Type);
+    const uintptr_t aligned = (address + alignment - 1) / alignment * alignment;
+    const size_t aligned_index = (aligned - base_address + sizeof(Type) - 1) / sizeof(Type);
+    return std::min(aligned_index, size);
+}
+
+// Делит [first, last) пополам, пока кусок длиннее grain: правая половина
+// ставится в очередь (её могут украсть), левая продолжает делиться в текущем потоке
+template <typename Type, typename Body>
+void SplitRange(TaskGroup& group, Type* first, Type* last, Body& body, size_t grain, size_t alignment) {
+    for (;;) {
+        const size_t size = static_cast<size_t>(last - first);
+        if (size <= grain) {
+            break;
+        }
+        const size_t middle = AlignChunkBoundary(first, size / 2, size, alignment);
+        if (middle == 0 || middle == size) {
+            break;
+        }
+        Type* right = first + middle;
+        group.Run([&group, &body, right, last, grain, alignment] {
+            SplitRange(group, right, last, body, grain, alignment);
+        });
+        last = right;
+    }
+    auto chunk = [&body, first, last] {
+        body(first, last);
+    };
+    group.RunHere(chunk);
+}
+
+// Выравнивание границ кусков для буфера аллокатора Allocator: не меньше строки кэша
+// и не меньше выравнивания буфера, так что каждый кусок начинается с выровненного адреса
+template <typename Allocator>
+inline constexpr size_t kChunkAlignment = std::max(kCacheLineSize, AllocatorAlignment<Allocator>::value);
+
+// Делит сегменты [first, last) вектора v пополам, как SplitRange: правая половина ставится
+// в очередь, каждый сегмент обрабатывается одной задачей. Сегменты — отдельные выделения,
+// поэтому границы задач выравнивать не нужно
+template <typename Vector, typename Body>
+void SplitSegments(TaskGroup& group, Vector& v, size_t first, size_t last, Body& body) {
+    while (last - first > 1) {
+        const size_t middle = first + (last - first) / 2;
+        group.Run([&group, &v, &body, middle, last] {
+            SplitSegments(group, v, middle, last, body);
+        });
+        last = middle;
+    }
+    auto segment = [&v, &body, first] {
+        auto [segment_first, segment_last] = v.GetSegment(first);
+        body(segment_first, segment_last);
+    };
+    group.RunHere(segment);
+}
+
+template <typename Vector, typename Body>
+void ParallelForSegments(Vector& v, Body& body, ThreadPool& pool) {
+    const size_t count = v.GetUsedSegmentCount();
+    if (count <= 1 || pool.GetThreadCount() == 0) {
+        v.ForEachSegment([&body](auto first, auto last) {
+            body(first, last);
+        });
+        return;
+    }
+    TaskGroup group(pool);
+    SplitSegments(group, v, 0, count, body);
+    group.Wait();
+}
+
+} // namespace simple_vector_detail
+
+// Базовый алгоритм: делит [first, last) на куски не длиннее grain элементов
+// (по возможности) и вызывает body(chunk_first, chunk_last) для каждого.
+// Все границы кусков, кроме краёв диапазона, выровнены по boundary_alignment байт
+// (степень двойки, по умолчанию — строка кэша; для первого касания страниц — размер страницы)
+template <typename Type, typename Body>
+void ParallelForChunks(Type* first, Type* last, Body body, ThreadPool& pool = DefaultThreadPool(),
+                       size_t grain = kDefaultGrainSize, size_t boundary_alignment = kCacheLineSize) {
+    const size_t size = static_cast<size_t>(last - first);
+    if (size == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    if (size <= grain || pool.GetThreadCount() == 0) {
+        body(first, last);
+        return;
+    }
+    simple_vector_detail::TaskGroup group(pool);
+    simple_vector_detail::SplitRange(group, first, last, body, grain, boundary_alignment);
+    group.Wait();
+}
+
+// Вызывает func для каждого элемента
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Func>
+void ParallelForEach(SimpleVector<Type, Allocator, GrowthPolicy>& v, Func func,
+                     ThreadPool& pool = DefaultThreadPool(), size_t grain = kDefaultGrainSize) {
+    ParallelForChunks(v.begin(), v.end(), [&func](Type* first, Type* last) {
+        std::for_each(first, last, func);
+    }, pool, grain, simple_vector_detail::kChunkAlignment<Allocator>);
+}
+
+// Записывает в out результаты func для каждого элемента in. Размер out становится равен размеру in.
+// Деление на куски идёт по out: туда пишут потоки
+template <typename In, typename InAllocator, typename InGrowth, typename Out, typename OutAllocator,
+          typename OutGrowth, typename Func>
+void ParallelTransform(const SimpleVector<In, InAllocator, InGrowth>& in, SimpleVector<Out, OutAllocator, OutGrowth>& out,
+                       Func func, ThreadPool& pool = DefaultThreadPool(), size_t grain = kDefaultGrainSize) {
+    out.ResizeDefaultInit(in.GetSize());
+    const In* source = in.begin();
+    Out* dest = out.begin();
+    ParallelForChunks(dest, dest + out.GetSize(), [&func, source, dest](Out* first, Out* last) {
+        std::transform(source + (first - dest), source + (last - dest), first, func);
+    }, pool, grain, simple_vector_detail::kChunkAlignment<OutAllocator>);
+}
+
+// Сворачивает элементы операцией op, которая должна быть ассоциативной:
+// куски сворачиваются независимо, затем их результаты — по порядку начиная с init
+template <typename Type, typename Allocator, typename GrowthPolicy, typename T, typename BinaryOp = std::plus<>>
+T ParallelReduce(const SimpleVector<Type, Allocator, GrowthPolicy>& v, T init, BinaryOp op = BinaryOp(),
+                 ThreadPool& pool = DefaultThreadPool(), size_t grain = kDefaultGrainSize) {
+    std::vector<std::pair<const Type*, T>> partials;
+    std::mutex partials_mutex;
+    ParallelForChunks(v.begin(), v.end(), [&](const Type* first, const Type* last) {
+        T value = std::accumulate(first + 1, last, static_cast<T>(*first), op);
+        std::lock_guard lock(partials_mutex);
+        partials.emplace_back(first, std::move(value));
+    }, pool, grain, simple_vector_detail::kChunkAlignment<Allocator>);
+    // куски завершаются в произвольном порядке, а для некоммутативной op он важен
+    std::sort(partials.begin(), partials.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+    for (auto& partial : partials) {
+        init = op(std::move(init), std::move(partial.second));
+    }
+    return init;
+}
+
+namespace simple_vector_detail {
+
+// Сортировка слиянием: половины сортируются параллельно, затем сливаются на месте
+template <typename Type, typename Compare>
+void ParallelMergeSort(ThreadPool& pool, Type* first, Type* last, Compare& comp, size_t grain, size_t alignment) {
+    const size_t size = static_cast<size_t>(last - first);
+    const size_t middle = size > grain ? AlignChunkBoundary(first, size / 2, size, alignment) : 0;
+    if (middle == 0 || middle == size) {
+        std::sort(first, last, comp);
+        return;
+    }
+    TaskGroup group(pool);
+    group.Run([&pool, first, middle, &comp, grain, alignment] {
+        ParallelMergeSort(pool, first, first + middle, comp, grain, alignment);
+    });
+    auto right_half = [&pool, first, middle, last, &comp, grain, alignment] {
+        ParallelMergeSort(pool, first + middle, last, comp, grain, alignment);
+    };
+    group.RunHere(right_half);
+    group.Wait();
+    std::inplace_merge(first, first + middle, last, comp);
+}
+
+} // namespace simple_vector_detail
+
+// Сортирует элементы: половины рекурсивно сортируются параллельно и сливаются
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Compare = std::less<>>
+void ParallelSort(SimpleVector<Type, Allocator, GrowthPolicy>& v, Compare comp = Compare(),
+                  ThreadPool& pool = DefaultThreadPool(), size_t grain = kDefaultGrainSize) {
+    if (pool.GetThreadCount() == 0) {
+        std::sort(v.begin(), v.end(), comp);
+        return;
+    }
+    simple_vector_detail::ParallelMergeSort(pool, v.begin(), v.end(), comp, std::max<size_t>(grain, 1),
+                                            simple_vector_detail::kChunkAlignment<Allocator>);
+}
+
+// Присваивает всем элементам значение value
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void ParallelFill(SimpleVector<Type, Allocator, GrowthPolicy>& v, const Type& value,
+                  ThreadPool& pool = DefaultThreadPool(), size_t grain = kDefaultGrainSize) {
+    ParallelForChunks(v.begin(), v.end(), [&value](Type* first, Type* last) {
+        std::fill(first, last, value);
+    }, pool, grain, simple_vector_detail::kChunkAlignment<Allocator>);
+}
+
+// Вызывает body(first, last) для непрерывного участка каждого сегмента, сегменты — параллельно
+template <typename Type, size_t SegmentSize, typename Allocator, typename Body>
+void ParallelForEachSegment(SegmentedSimpleVector<Type, SegmentSize, Allocator>& v, Body body,
+                            ThreadPool& pool = DefaultThreadPool()) {
+    simple_vector_detail::ParallelForSegments(v, body, pool);
+}
+
+template <typename Type, size_t SegmentSize, typename Allocator, typename Body>
+void ParallelForEachSegment(const SegmentedSimpleVector<Type, SegmentSize, Allocator>& v, Body body,
+                            ThreadPool& pool = DefaultThreadPool()) {
+    simple_vector_detail::ParallelForSegments(v, body, pool);
+}
+
+// Вызывает func для каждого элемента сегментированного вектора
+template <typename Type, size_t SegmentSize, typename Allocator, typename Func>
+void ParallelForEach(SegmentedSimpleVector<Type, SegmentSize, Allocator>& v, Func func,
+                     ThreadPool& pool = DefaultThreadPool()) {
+    ParallelForEachSegment(v, [&func](Type* first, Type* last) {
+        std::for_each(first, last, func);
+    }, pool);
+}
@@ -0,0 +1,583 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array_ptr.h"
+#include "simple_vector.h"
+#include "uninitialized.h"
+
+namespace simple_vector_detail {
+
+// Размер сегмента по умолчанию: наибольшая степень двойки элементов, умещающаяся в 64 КиБ
+// (но не меньше одного элемента)
+template <typename Type>
+constexpr size_t DefaultSegmentSize() noexcept {
+    size_t size = 1;
+    while (size * 2 * sizeof(Type) <= 64 * 1024) {
+        size *= 2;
+    }
+    return size;
+}
+
+} // namespace simple_vector_detail
+
+// Сегментированный вектор: элементы лежат в сегментах по SegmentSize штук, выделяемых
+// по одному при росте. Уже созданные элементы никогда не переносятся, поэтому указатели
+// и ссылки на них остаются действительными при PushBack, Reserve и Resize, а рост
+// не требует временно держать в памяти старый и новый буферы сразу.
+// Перевыделяется только таблица сегментов (по указателю на сегмент), индекс i
+// находится за O(1): сегмент i / SegmentSize, смещение i % SegmentSize.
+// Итераторы произвольного доступа хранят вектор и индекс и переживают рост таблицы.
+// ForEachSegment и ParallelForEachSegment (parallel.h) обходят данные непрерывными участками
+template <typename Type, size_t SegmentSize = simple_vector_detail::DefaultSegmentSize<Type>(),
+          typename Allocator = std::allocator<Type>>
+class SegmentedSimpleVector : private simple_vector_detail::AllocatorHolder<Allocator> {
+    static_assert(SegmentSize > 0 && (SegmentSize & (SegmentSize - 1)) == 0,
+                  "Segment size must be a power of two");
+
+    using Holder = simple_vector_detail::AllocatorHolder<Allocator>;
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using Segment = ArrayPtr<Type, Allocator>;
+
+    template <typename Owner, typename Ref>
+    class BasicIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_const_t<Type>;
+        using difference_type = std::ptrdiff_t;
+        using reference = Ref;
+        using pointer = std::remove_reference_t<Ref>*;
+
+        BasicIterator() = default;
+
+        template <typename OtherOwner, typename OtherRef,
+                  typename = std::enable_if_t<std::is_convertible_v<OtherOwner*, Owner*>>>
+        BasicIterator(const BasicIterator<OtherOwner, OtherRef>& other) noexcept
+            : owner_(other.owner_), index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*owner_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + static_cast<size_t>(offset)];
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator copy = *this;
+            --index_;
+            return copy;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += static_cast<size_t>(offset);
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= static_cast<size_t>(offset);
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_ - rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+    private:
+        template <typename, typename>
+        friend class BasicIterator;
+        friend class SegmentedSimpleVector;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner), index_(index) {
+        }
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using Iterator = BasicIterator<SegmentedSimpleVector, Type&>;
+    using ConstIterator = BasicIterator<const SegmentedSimpleVector, const Type&>;
+    using allocator_type = Allocator;
+
+    // Количество элементов в одном сегменте
+    static constexpr size_t kSegmentSize = SegmentSize;
+
+    SegmentedSimpleVector() noexcept(noexcept(Allocator())) = default;
+
+    // Остальные конструкторы делегируют этому: если создание элементов бросит исключение,
+    // деструктор разрушит уже созданные
+    explicit SegmentedSimpleVector(const Allocator& alloc) noexcept
+        : Holder(alloc) {
+    }
+
+    // Создаёт size элементов, инициализированных значением по умолчанию
+    explicit SegmentedSimpleVector(size_t size, const Allocator& alloc = Allocator())
+        : SegmentedSimpleVector(alloc) {
+        Resize(size);
+    }
+
+    // Создаёт size элементов, инициализированных значением value
+    SegmentedSimpleVector(size_t size, const Type& value, const Allocator& alloc = Allocator())
+        : SegmentedSimpleVector(alloc) {
+        Reserve(size);
+        while (size_ < size) {
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedSimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator())
+        : SegmentedSimpleVector(alloc) {
+        Reserve(init.size());
+        for (const Type& item : init) {
+            EmplaceBack(item);
+        }
+    }
+
+    SegmentedSimpleVector(const SegmentedSimpleVector& other)
+        : SegmentedSimpleVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    // Конструктор копирования с явно заданным аллокатором
+    SegmentedSimpleVector(const SegmentedSimpleVector& other, const Allocator& alloc)
+        : SegmentedSimpleVector(alloc) {
+        Reserve(other.size_);
+        other.ForEachSegment([this](const Type* first, const Type* last) {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        });
+    }
+
+    // Забирает таблицу сегментов целиком, элементы не перемещаются
+    SegmentedSimpleVector(SegmentedSimpleVector&& other) noexcept
+        : Holder(other.GetAllocator()), segments_(std::move(other.segments_)), size_(std::exchange(other.size_, 0)) {
+    }
+
+    // Конструктор перемещения с явно заданным аллокатором.
+    // Если аллокаторы не равны, элементы перемещаются по одному в сегменты аллокатора alloc
+    SegmentedSimpleVector(SegmentedSimpleVector&& other, const Allocator& alloc)
+        : SegmentedSimpleVector(alloc) {
+        if (Holder::GetAllocator() == other.GetAllocator()) {
+            TakeSegments(other);
+            return;
+        }
+        Reserve(other.size_);
+        other.ForEachSegment([this](Type* first, Type* last) {
+            for (; first != last; ++first) {
+                EmplaceBack(std::move(*first));
+            }
+        });
+        other.Clear();
+    }
+
+    ~SegmentedSimpleVector() {
+        Clear();
+    }
+
+    // Строгая гарантия: копия строится целиком до замены содержимого.
+    // Аллокатор rhs копируется, только если он распространяется при копирующем присваивании
+    SegmentedSimpleVector& operator=(const SegmentedSimpleVector& rhs) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                SegmentedSimpleVector copy(rhs, rhs.GetAllocator());
+                TakeSegments(copy);
+                Holder::GetAllocator() = rhs.GetAllocator();
+            } else {
+                SegmentedSimpleVector copy(rhs, Holder::GetAllocator());
+                TakeSegments(copy);
+            }
+        }
+        return *this;
+    }
+
+    // Прежние элементы разрушаются.
+    // Если аллокатор не распространяется при перемещении и не равен аллокатору rhs,
+    // элементы rhs перемещаются по одному в сегменты текущего аллокатора
+    SegmentedSimpleVector& operator=(SegmentedSimpleVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                                           || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                TakeSegments(rhs);
+                Holder::GetAllocator() = rhs.GetAllocator();
+            } else if constexpr (AllocTraits::is_always_equal::value) {
+                TakeSegments(rhs);
+            } else if (Holder::GetAllocator() == rhs.GetAllocator()) {
+                TakeSegments(rhs);
+            } else {
+                SegmentedSimpleVector moved(std::move(rhs), Holder::GetAllocator());
+                TakeSegments(moved);
+            }
+        }
+        return *this;
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return Holder::GetAllocator();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает количество элементов, помещающихся в выделенные сегменты
+    size_t GetCapacity() const noexcept {
+        return segments_.GetSize() * SegmentSize;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает количество выделенных сегментов
+    size_t GetSegmentCount() const noexcept {
+        return segments_.GetSize();
+    }
+
+    // Выделяет сегменты так, чтобы вместилось new_capacity элементов. Элементы не переносятся
+    void Reserve(size_t new_capacity) {
+        const size_t segment_count = (new_capacity + SegmentSize - 1) / SegmentSize;
+        if (segment_count <= segments_.GetSize()) {
+            return;
+        }
+        segments_.Reserve(segment_count);
+        while (segments_.GetSize() < segment_count) {
+            segments_.EmplaceBack(SegmentSize, Holder::GetAllocator());
+        }
+    }
+
+    // Освобождает сегменты, в которых нет элементов
+    void ShrinkToFit() {
+        const size_t segment_count = (size_ + SegmentSize - 1) / SegmentSize;
+        segments_.Resize(segment_count);
+        segments_.ShrinkToFit();
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент в конце вектора. При нехватке места выделяется новый сегмент,
+    // остальные элементы остаются на месте
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == GetCapacity()) {
+            Reserve(size_ + 1);
+        }
+        Type* slot = Slot(size_);
+        simple_vector_detail::ConstructAt(Holder::GetAllocator(), slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    // Вставляет value в позицию pos, сдвигая последующие элементы на одну позицию
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos.index_ <= size_);
+        const size_t index = pos.index_;
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return Iterator(this, index);
+        }
+        // аргументы могут ссылаться на сдвигаемый элемент, поэтому сначала создаём значение
+        Type temp_value(std::forward<Args>(args)...);
+        EmplaceBack(std::move(Back()));
+        std::move_backward(begin() + static_cast<std::ptrdiff_t>(index), end() - 2, end() - 1);
+        (*this)[index] = std::move(temp_value);
+        return Iterator(this, index);
+    }
+
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        simple_vector_detail::DestroyAt(Holder::GetAllocator(), Slot(size_));
+    }
+
+    // Удаляет элемент в позиции pos и возвращает итератор на следующий
+    Iterator Erase(ConstIterator pos) {
+        assert(pos.index_ < size_);
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last), сдвигая хвост
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(first.index_ <= last.index_ && last.index_ <= size_);
+        const size_t count = last.index_ - first.index_;
+        std::move(begin() + static_cast<std::ptrdiff_t>(last.index_), end(), begin() + static_cast<std::ptrdiff_t>(first.index_));
+        for (size_t i = 0; i < count; ++i) {
+            PopBack();
+        }
+        return Iterator(this, first.index_);
+    }
+
+    // Изменяет размер; новые элементы получают значение по умолчанию
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            Reserve(new_size);
+            while (size_ < new_size) {
+                const size_t count = std::min(new_size - size_, SegmentSize - size_ % SegmentSize);
+                simple_vector_detail::UninitializedValueConstruct(Holder::GetAllocator(), Slot(size_), count);
+                size_ += count;
+            }
+        } else {
+            while (size_ > new_size) {
+                PopBack();
+            }
+        }
+    }
+
+    // Разрушает элементы; сегменты остаются выделенными
+    void Clear() noexcept {
+        ForEachSegment([this](Type* first, Type* last) {
+            simple_vector_detail::DestroyRange(Holder::GetAllocator(), first, last);
+        });
+        size_ = 0;
+    }
+
+    void swap(SegmentedSimpleVector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(Holder::GetAllocator(), other.Holder::GetAllocator());
+        } else {
+            assert(Holder::GetAllocator() == other.Holder::GetAllocator());
+        }
+        segments_.swap(other.segments_);
+        std::swap(size_, other.size_);
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("out of range");
+        }
+        return *Slot(index);
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out of range");
+        }
+        return *Slot(index);
+    }
+
+    Type& Front() noexcept {
+        return (*this)[0];
+    }
+
+    const Type& Front() const noexcept {
+        return (*this)[0];
+    }
+
+    Type& Back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    const Type& Back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    // Возвращает непрерывный участок элементов сегмента segment: [first, last)
+    std::pair<Type*, Type*> GetSegment(size_t segment) noexcept {
+        assert(segment * SegmentSize < size_);
+        Type* first = segments_[segment].Get();
+        return {first, first + std::min(SegmentSize, size_ - segment * SegmentSize)};
+    }
+
+    std::pair<const Type*, const Type*> GetSegment(size_t segment) const noexcept {
+        assert(segment * SegmentSize < size_);
+        const Type* first = segments_[segment].Get();
+        return {first, first + std::min(SegmentSize, size_ - segment * SegmentSize)};
+    }
+
+    // Возвращает количество сегментов, в которых есть элементы
+    size_t GetUsedSegmentCount() const noexcept {
+        return (size_ + SegmentSize - 1) / SegmentSize;
+    }
+
+    // Вызывает func(first, last) для непрерывного участка элементов каждого сегмента по порядку.
+    // Внутри участка работают обычные циклы по указателям и SIMD-алгоритмы
+    template <typename Func>
+    void ForEachSegment(Func func) {
+        for (size_t segment = 0, count = GetUsedSegmentCount(); segment < count; ++segment) {
+            auto [first, last] = GetSegment(segment);
+            func(first, last);
+        }
+    }
+
+    template <typename Func>
+    void ForEachSegment(Func func) const {
+        for (size_t segment = 0, count = GetUsedSegmentCount(); segment < count; ++segment) {
+            auto [first, last] = GetSegment(segment);
+            func(first, last);
+        }
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Разрушает свои элементы и забирает сегменты other; аллокатор не меняется.
+    // Сегменты other должны быть выделены аллокатором, равным итоговому аллокатору вектора
+    void TakeSegments(SegmentedSimpleVector& other) noexcept {
+        Clear();
+        segments_ = std::move(other.segments_);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    // Адрес ячейки index: сегмент и смещение в нём вычисляются сдвигом и маской
+    Type* Slot(size_t index) const noexcept {
+        return segments_[index / SegmentSize].Get() + index % SegmentSize;
+    }
+
+    SimpleVector<Segment> segments_;
+    size_t size_ = 0;
+};
+
+template <typename Type, size_t SegmentSize, typename Allocator>
+inline bool operator==(const SegmentedSimpleVector<Type, SegmentSize, Allocator>& lhs,
+                       const SegmentedSimpleVector<Type, SegmentSize, Allocator>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Type, size_t SegmentSize, typename Allocator>
+inline bool operator!=(const SegmentedSimpleVector<Type, SegmentSize, Allocator>& lhs,
+                       const SegmentedSimpleVector<Type, SegmentSize, Allocator>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t SegmentSize, typename Allocator>
+inline bool operator<(const SegmentedSimpleVector<Type, SegmentSize, Allocator>& lhs,
+                      const SegmentedSimpleVector<Type, SegmentSize, Allocator>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, size_t SegmentSize, typename Allocator>
+inline bool operator<=(const SegmentedSimpleVector<Type, SegmentSize, Allocator>& lhs,
+                       const SegmentedSimpleVector<Type, SegmentSize, Allocator>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t SegmentSize, typename Allocator>
+inline bool operator>(const SegmentedSimpleVector<Type, SegmentSize, Allocator>& lhs,
+                      const SegmentedSimpleVector<Type, SegmentSize, Allocator>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t SegmentSize, typename Allocator>
+inline bool operator>=(const SegmentedSimpleVector<Type, SegmentSize, Allocator>& lhs,
+                       const SegmentedSimpleVector<Type, SegmentSize, Allocator>& rhs) {
+    return !(lhs < rhs);
+}
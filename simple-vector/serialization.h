@@ -0,0 +1,452 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "simple_vector.h"
+
+// Двоичный формат SimpleVector тривиально копируемых элементов:
+// заголовок SerializedHeader, затем элементы в памяти «как есть».
+// Запись в файловый дескриптор — один writev заголовка и элементов, чтение — прямо
+// в буфер вектора, без поэлементной работы. Контрольная сумма покрывает элементы.
+// Файл, записанный на машине с другим порядком байтов, читается для арифметических
+// типов (байты каждого элемента переставляются); для остальных типов это ошибка.
+// Количество элементов из заголовка не доверяется: если длина источника известна
+// (обычный файл, поток с позиционированием), оно сверяется с ней до выделения памяти,
+// иначе буфер растёт только по мере прихода данных.
+// Ошибки формата выбрасываются как std::runtime_error, ошибки ввода-вывода дескриптора —
+// как std::system_error, ошибки потока — как std::runtime_error
+
+inline constexpr uint32_t kSerializedEndianTag = 0x01020304;
+
+struct SerializedHeader {
+    char magic[8];
+    uint32_t endian_tag;     // kSerializedEndianTag в порядке байтов записавшей машины
+    uint32_t element_size;
+    uint32_t alignment;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t checksum;       // Checksum64 от байтов элементов
+};
+
+static_assert(sizeof(SerializedHeader) == 40);
+
+namespace simple_vector_detail {
+
+inline constexpr char kSerializedMagic[8] = {'S', 'V', 'S', 'E', 'R', '\0', '\0', '\1'};
+
+inline uint32_t ByteSwap(uint32_t value) noexcept {
+    return (value >> 24) | ((value >> 8) & 0xFF00u) | ((value << 8) & 0xFF0000u) | (value << 24);
+}
+
+inline uint64_t ByteSwap(uint64_t value) noexcept {
+    return (static_cast<uint64_t>(ByteSwap(static_cast<uint32_t>(value))) << 32)
+        | ByteSwap(static_cast<uint32_t>(value >> 32));
+}
+
+inline void ByteSwapElements(void* data, size_t count, size_t element_size) noexcept {
+    auto* bytes = static_cast<unsigned char*>(data);
+    for (size_t i = 0; i < count; ++i, bytes += element_size) {
+        std::reverse(bytes, bytes + element_size);
+    }
+}
+
+// Читает 8 байт как число в порядке little-endian независимо от порядка байтов машины
+inline uint64_t LoadLittleEndian64(const unsigned char* bytes) noexcept {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+inline uint64_t RotateLeft(uint64_t value, int shift) noexcept {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+} // namespace simple_vector_detail
+
+// Потоковая 64-битная контрольная сумма: четыре независимые дорожки по 8 байт,
+// так что цепочки умножений не ждут друг друга. Результат не зависит от того,
+// какими порциями подаются данные, и от порядка байтов машины: слова читаются
+// как little-endian. Не криптографическая
+class Checksum64 {
+public:
+    void Update(const void* data, size_t bytes) noexcept {
+        if (bytes == 0) {
+            return;
+        }
+        const auto* input = static_cast<const unsigned char*>(data);
+        total_ += bytes;
+        if (pending_ > 0) {
+            const size_t take = std::min(bytes, kBlockBytes - pending_);
+            std::memcpy(block_ + pending_, input, take);
+            pending_ += take;
+            input += take;
+            bytes -= take;
+            if (pending_ < kBlockBytes) {
+                return;
+            }
+            Consume(block_);
+            pending_ = 0;
+        }
+        for (; bytes >= kBlockBytes; bytes -= kBlockBytes, input += kBlockBytes) {
+            Consume(input);
+        }
+        std::memcpy(block_, input, bytes);
+        pending_ = bytes;
+    }
+
+    uint64_t Finish() const noexcept {
+        uint64_t result = total_ * kPrime2;
+        for (uint64_t lane : lanes_) {
+            result = Mix(result ^ lane);
+        }
+        for (size_t i = 0; i < pending_; ++i) {
+            result = Mix(result ^ (block_[i] + (static_cast<uint64_t>(i) << 8)));
+        }
+        return Mix(result);
+    }
+
+    static uint64_t Of(const void* data, size_t bytes) noexcept {
+        Checksum64 checksum;
+        checksum.Update(data, bytes);
+        return checksum.Finish();
+    }
+
+private:
+    static constexpr size_t kBlockBytes = 32;
+    static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+    static uint64_t Mix(uint64_t value) noexcept {
+        value ^= value >> 33;
+        value *= kPrime2;
+        value ^= value >> 29;
+        return value;
+    }
+
+    void Consume(const unsigned char* block) noexcept {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            const uint64_t word = simple_vector_detail::LoadLittleEndian64(block + lane * 8);
+            lanes_[lane] = simple_vector_detail::RotateLeft(lanes_[lane] + word * kPrime2, 31) * kPrime1;
+        }
+    }
+
+    uint64_t lanes_[4] = {kPrime1, kPrime2, ~kPrime1, ~kPrime2};
+    uint64_t total_ = 0;
+    unsigned char block_[kBlockBytes] = {};
+    size_t pending_ = 0;
+};
+
+namespace simple_vector_detail {
+
+template <typename Type>
+SerializedHeader MakeHeader(const Type* data, size_t count) noexcept {
+    SerializedHeader header{};
+    std::memcpy(header.magic, kSerializedMagic, sizeof(header.magic));
+    header.endian_tag = kSerializedEndianTag;
+    header.element_size = sizeof(Type);
+    header.alignment = alignof(Type);
+    header.count = count;
+    header.checksum = Checksum64::Of(data, count * sizeof(Type));
+    return header;
+}
+
+// Проверяет заголовок и приводит его поля к своему порядку байтов.
+// Возвращает true, если элементы записаны в другом порядке байтов
+template <typename Type>
+bool ValidateHeader(SerializedHeader& header) {
+    if (std::memcmp(header.magic, kSerializedMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("SimpleVector deserialization: bad signature");
+    }
+    bool swapped = false;
+    if (header.endian_tag != kSerializedEndianTag) {
+        if (ByteSwap(header.endian_tag) != kSerializedEndianTag) {
+            throw std::runtime_error("SimpleVector deserialization: bad byte order tag");
+        }
+        if constexpr (!std::is_arithmetic_v<Type>) {
+            throw std::runtime_error("SimpleVector deserialization: foreign byte order for a non-arithmetic type");
+        }
+        swapped = true;
+        header.element_size = ByteSwap(header.element_size);
+        header.alignment = ByteSwap(header.alignment);
+        header.count = ByteSwap(header.count);
+        header.checksum = ByteSwap(header.checksum);
+    }
+    if (header.element_size != sizeof(Type) || header.alignment != alignof(Type)) {
+        throw std::runtime_error("SimpleVector deserialization: element layout mismatch");
+    }
+    if (header.count > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+        throw std::runtime_error("SimpleVector deserialization: element count is too large");
+    }
+    return swapped;
+}
+
+// Источник байтов: поток или файловый дескриптор. Read возвращает меньше bytes только в конце данных
+class ByteSource {
+public:
+    explicit ByteSource(std::istream& in) noexcept
+        : stream_(&in) {
+    }
+
+    explicit ByteSource(int fd) noexcept
+        : fd_(fd) {
+    }
+
+    size_t Read(void* data, size_t bytes) {
+        auto* out = static_cast<char*>(data);
+        size_t done = 0;
+        while (done < bytes) {
+            const size_t step = std::min<size_t>(bytes - done, kMaxStep);
+            size_t got = 0;
+            if (stream_ != nullptr) {
+                stream_->read(out + done, static_cast<std::streamsize>(step));
+                got = static_cast<size_t>(stream_->gcount());
+                if (stream_->bad()) {
+                    throw std::runtime_error("SimpleVector deserialization: stream read failed");
+                }
+            } else {
+                const ssize_t result = ::read(fd_, out + done, step);
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "read");
+                }
+                got = static_cast<size_t>(result);
+            }
+            if (got == 0) {
+                break;
+            }
+            done += got;
+        }
+        return done;
+    }
+
+    void ReadExactly(void* data, size_t bytes) {
+        if (Read(data, bytes) != bytes) {
+            throw std::runtime_error("SimpleVector deserialization: unexpected end of data");
+        }
+    }
+
+    // Возвращает количество байтов до конца источника или nullopt, если оно неизвестно (канал, сокет)
+    std::optional<uint64_t> GetAvailable() {
+        if (stream_ != nullptr) {
+            const std::streampos position = stream_->tellg();
+            if (position == std::streampos(-1)) {
+                return std::nullopt;
+            }
+            stream_->seekg(0, std::ios_base::end);
+            const std::streampos end = stream_->tellg();
+            stream_->clear();
+            stream_->seekg(position);
+            if (end == std::streampos(-1) || end < position) {
+                return std::nullopt;
+            }
+            return static_cast<uint64_t>(end - position);
+        }
+        struct stat info{};
+        if (::fstat(fd_, &info) != 0 || !S_ISREG(info.st_mode)) {
+            return std::nullopt;
+        }
+        const off_t position = ::lseek(fd_, 0, SEEK_CUR);
+        if (position < 0 || position > info.st_size) {
+            return std::nullopt;
+        }
+        return static_cast<uint64_t>(info.st_size - position);
+    }
+
+private:
+    static constexpr size_t kMaxStep = size_t{1} << 30;
+
+    std::istream* stream_ = nullptr;
+    int fd_ = -1;
+};
+
+inline void WriteToStream(std::ostream& out, const void* data, size_t bytes) {
+    constexpr size_t max_step = size_t{1} << 30;
+    const auto* input = static_cast<const char*>(data);
+    for (size_t done = 0; done < bytes;) {
+        const size_t step = std::min(bytes - done, max_step);
+        out.write(input + done, static_cast<std::streamsize>(step));
+        done += step;
+    }
+    if (!out) {
+        throw std::runtime_error("SimpleVector serialization: stream write failed");
+    }
+}
+
+} // namespace simple_vector_detail
+
+// Записывает вектор в поток: заголовок и элементы одним блоком
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Serialize(const SimpleVector<Type, Allocator, GrowthPolicy>& v, std::ostream& out) {
+    static_assert(std::is_trivially_copyable_v<Type>, "Serialization requires a trivially copyable type");
+    const SerializedHeader header = simple_vector_detail::MakeHeader(v.begin(), v.GetSize());
+    simple_vector_detail::WriteToStream(out, &header, sizeof(header));
+    simple_vector_detail::WriteToStream(out, v.begin(), v.GetSize() * sizeof(Type));
+}
+
+// Записывает вектор в файловый дескриптор одним writev (повторяя его при частичной записи)
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Serialize(const SimpleVector<Type, Allocator, GrowthPolicy>& v, int fd) {
+    static_assert(std::is_trivially_copyable_v<Type>, "Serialization requires a trivially copyable type");
+    SerializedHeader header = simple_vector_detail::MakeHeader(v.begin(), v.GetSize());
+    iovec parts[2] = {
+        {&header, sizeof(header)},
+        {const_cast<Type*>(v.begin()), v.GetSize() * sizeof(Type)},
+    };
+    iovec* current = parts;
+    int remaining = 2;
+    while (remaining > 0) {
+        const ssize_t written = ::writev(fd, current, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        auto left = static_cast<size_t>(written);
+        while (remaining > 0 && left >= current->iov_len) {
+            left -= current->iov_len;
+            ++current;
+            --remaining;
+        }
+        if (remaining > 0) {
+            current->iov_base = static_cast<char*>(current->iov_base) + left;
+            current->iov_len -= left;
+        }
+    }
+}
+
+// Последовательно читает сериализованный вектор порциями, не загружая его целиком:
+// подходит для данных больше оперативной памяти. Контрольная сумма проверяется
+// после чтения последней порции
+template <typename Type>
+class SimpleVectorReader {
+    static_assert(std::is_trivially_copyable_v<Type>, "Serialization requires a trivially copyable type");
+
+public:
+    explicit SimpleVectorReader(std::istream& in)
+        : source_(in) {
+        ReadHeader();
+    }
+
+    explicit SimpleVectorReader(int fd)
+        : source_(fd) {
+        ReadHeader();
+    }
+
+    // Возвращает общее количество элементов
+    size_t GetCount() const noexcept {
+        return static_cast<size_t>(header_.count);
+    }
+
+    // Возвращает количество ещё не прочитанных элементов
+    size_t GetRemaining() const noexcept {
+        return GetCount() - read_;
+    }
+
+    // Заменяет содержимое chunk следующими (не более max_count) элементами.
+    // Вместимость chunk переиспользуется, а при нехватке становится ровно равной порции.
+    // Возвращает количество прочитанных элементов, 0 — когда данные закончились
+    template <typename Allocator, typename GrowthPolicy>
+    size_t ReadChunk(SimpleVector<Type, Allocator, GrowthPolicy>& chunk, size_t max_count) {
+        const size_t count = std::min(max_count, GetRemaining());
+        chunk.Clear();
+        // при неизвестной длине источника буфер не больше чем вдвое превышает уже прочитанное
+        const size_t first_step = length_checked_ ? count : kUncheckedStep;
+        while (chunk.GetSize() < count) {
+            const size_t filled = chunk.GetSize();
+            const size_t step = std::min(count - filled, std::max(first_step, filled));
+            chunk.Reserve(filled + step);
+            chunk.ResizeDefaultInit(filled + step);
+            ReadInto(chunk.begin() + filled, step);
+        }
+        return count;
+    }
+
+    // Читает следующие count элементов в неинициализированную память dest
+    void ReadInto(Type* dest, size_t count) {
+        if (count > GetRemaining()) {
+            throw std::out_of_range("SimpleVectorReader: read past the end");
+        }
+        const size_t bytes = count * sizeof(Type);
+        source_.ReadExactly(dest, bytes);
+        checksum_.Update(dest, bytes);
+        if (swapped_) {
+            simple_vector_detail::ByteSwapElements(dest, count, sizeof(Type));
+        }
+        read_ += count;
+        if (read_ == GetCount() && checksum_.Finish() != header_.checksum) {
+            throw std::runtime_error("SimpleVector deserialization: checksum mismatch");
+        }
+    }
+
+private:
+    void ReadHeader() {
+        source_.ReadExactly(&header_, sizeof(header_));
+        swapped_ = simple_vector_detail::ValidateHeader<Type>(header_);
+        if (const std::optional<uint64_t> available = source_.GetAvailable()) {
+            if (header_.count * sizeof(Type) > *available) {
+                throw std::runtime_error("SimpleVector deserialization: unexpected end of data");
+            }
+            length_checked_ = true;
+        }
+        if (header_.count == 0 && Checksum64::Of(nullptr, 0) != header_.checksum) {
+            throw std::runtime_error("SimpleVector deserialization: checksum mismatch");
+        }
+    }
+
+    // порция чтения из источника неизвестной длины, пока данные не подтвердили заголовок
+    static constexpr size_t kUncheckedStep = std::max<size_t>(1, (size_t{1} << 20) / sizeof(Type));
+
+    simple_vector_detail::ByteSource source_;
+    SerializedHeader header_{};
+    Checksum64 checksum_;
+    size_t read_ = 0;
+    bool swapped_ = false;
+    bool length_checked_ = false;
+};
+
+namespace simple_vector_detail {
+
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Source>
+void ReadWhole(Source& source, SimpleVector<Type, Allocator, GrowthPolicy>& out) {
+    try {
+        SimpleVectorReader<Type> reader(source);
+        reader.ReadChunk(out, reader.GetCount());
+    } catch (...) {
+        out.Clear();
+        throw;
+    }
+}
+
+} // namespace simple_vector_detail
+
+// Заменяет содержимое out вектором из потока. Элементы читаются прямо в буфер out
+// (его вместимость переиспользуется). При ошибке out остаётся пустым
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Deserialize(std::istream& in, SimpleVector<Type, Allocator, GrowthPolicy>& out) {
+    simple_vector_detail::ReadWhole(in, out);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Deserialize(int fd, SimpleVector<Type, Allocator, GrowthPolicy>& out) {
+    simple_vector_detail::ReadWhole(fd, out);
+}
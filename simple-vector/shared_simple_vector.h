@@ -0,0 +1,289 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "simple_vector.h"
+
+// Вектор с разделяемым буфером и копированием при записи (copy-on-write).
+// Копия увеличивает атомарный счётчик ссылок и не трогает элементы; собственный буфер
+// создаётся при первом изменении, только если буфер разделён с другими копиями.
+// Как и std::shared_ptr: разные объекты с общим буфером можно читать и менять из разных
+// потоков одновременно, а один объект из нескольких потоков — только читать.
+// Ссылки и итераторы, полученные для чтения, становятся недействительными после изменения.
+// Изменяемых ссылок вектор не выдаёт: иначе запись через ссылку, сохранённую до Snapshot(),
+// изменила бы и «неизменяемый» снимок. Произвольные изменения делаются внутри Modify
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class SharedSimpleVector {
+public:
+    using Vector = SimpleVector<Type, Allocator, GrowthPolicy>;
+    using ConstIterator = typename Vector::ConstIterator;
+    using allocator_type = Allocator;
+
+private:
+    struct Block {
+        template <typename... Args>
+        explicit Block(Args&&... args)
+            : data(std::forward<Args>(args)...) {
+        }
+
+        std::atomic<size_t> refs = 1;
+        Vector data;
+    };
+
+public:
+    SharedSimpleVector() noexcept = default;
+
+    // Забирает элементы обычного вектора без копирования
+    SharedSimpleVector(Vector&& data)
+        : block_(MakeBlock(std::move(data))) {
+    }
+
+    SharedSimpleVector(const Vector& data)
+        : block_(MakeBlock(data)) {
+    }
+
+    SharedSimpleVector(std::initializer_list<Type> init)
+        : block_(MakeBlock(init)) {
+    }
+
+    SharedSimpleVector(size_t size, const Type& value)
+        : block_(MakeBlock(size, value)) {
+    }
+
+    // Копия разделяет буфер: элементы не копируются
+    SharedSimpleVector(const SharedSimpleVector& other) noexcept
+        : block_(other.block_) {
+        if (block_ != nullptr) {
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    SharedSimpleVector(SharedSimpleVector&& other) noexcept
+        : block_(std::exchange(other.block_, nullptr)) {
+    }
+
+    ~SharedSimpleVector() {
+        ReleaseBlock(block_);
+    }
+
+    SharedSimpleVector& operator=(const SharedSimpleVector& rhs) noexcept {
+        SharedSimpleVector(rhs).swap(*this);
+        return *this;
+    }
+
+    SharedSimpleVector& operator=(SharedSimpleVector&& rhs) noexcept {
+        SharedSimpleVector(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    // Возвращает неизменяемый снимок текущего содержимого; стоит одного атомарного инкремента
+    SharedSimpleVector Snapshot() const noexcept {
+        return *this;
+    }
+
+    // Возвращает количество объектов, разделяющих буфер (0 для пустого вектора без буфера)
+    size_t UseCount() const noexcept {
+        return block_ != nullptr ? block_->refs.load(std::memory_order_acquire) : 0;
+    }
+
+    // Сообщает, владеет ли объект буфером единолично
+    bool IsUnique() const noexcept {
+        return UseCount() <= 1;
+    }
+
+    // Возвращает содержимое только для чтения
+    const Vector& Get() const noexcept {
+        return block_ != nullptr ? block_->data : EmptyVector();
+    }
+
+    // Вызывает func(Vector&) для изменения содержимого и возвращает её результат.
+    // Если буфер разделён, сначала копирует его. Ссылки, указатели и итераторы на элементы
+    // не должны переживать вызов: после него буфер может разделить снимок
+    template <typename Func>
+    auto Modify(Func&& func) {
+        return std::forward<Func>(func)(Detached());
+    }
+
+    // Извлекает содержимое в обычный вектор: без копирования, если буфер не разделён
+    Vector ToSimpleVector() && {
+        if (block_ == nullptr) {
+            return Vector();
+        }
+        Vector result = IsUnique() ? std::move(block_->data) : block_->data;
+        ReleaseBlock(std::exchange(block_, nullptr));
+        return result;
+    }
+
+    size_t GetSize() const noexcept {
+        return Get().GetSize();
+    }
+
+    size_t GetCapacity() const noexcept {
+        return Get().GetCapacity();
+    }
+
+    bool IsEmpty() const noexcept {
+        return Get().IsEmpty();
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return Get()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        return Get().At(index);
+    }
+
+    ConstIterator Find(const Type& value) const {
+        return Get().Find(value);
+    }
+
+    size_t Count(const Type& value) const {
+        return Get().Count(value);
+    }
+
+    bool Contains(const Type& value) const {
+        return Get().Contains(value);
+    }
+
+    // Изменяющие методы копируют разделённый буфер перед изменением
+
+    // Присваивает элементу index значение value.
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    void Set(size_t index, const Type& value) {
+        Detached().At(index) = value;
+    }
+
+    void Set(size_t index, Type&& value) {
+        Detached().At(index) = std::move(value);
+    }
+
+    void PushBack(const Type& item) {
+        Detached().PushBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        Detached().PushBack(std::move(item));
+    }
+
+    // Возвращает ссылку на созданный элемент только для чтения
+    template <typename... Args>
+    const Type& EmplaceBack(Args&&... args) {
+        return Detached().EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    void PopBack() {
+        if (!IsEmpty()) {
+            Detached().PopBack();
+        }
+    }
+
+    void Resize(size_t new_size) {
+        Detached().Resize(new_size);
+    }
+
+    void Reserve(size_t new_capacity) {
+        Detached().Reserve(new_capacity);
+    }
+
+    // Очищает вектор. Разделённый буфер не копируется, а просто отпускается
+    void Clear() noexcept {
+        if (IsUnique()) {
+            if (block_ != nullptr) {
+                block_->data.Clear();
+            }
+        } else {
+            ReleaseBlock(std::exchange(block_, nullptr));
+        }
+    }
+
+    ConstIterator begin() const noexcept {
+        return Get().begin();
+    }
+
+    ConstIterator end() const noexcept {
+        return Get().end();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    void swap(SharedSimpleVector& other) noexcept {
+        std::swap(block_, other.block_);
+    }
+
+private:
+    static const Vector& EmptyVector() noexcept {
+        static const Vector empty;
+        return empty;
+    }
+
+    // Блок со счётчиком выделяется обычным new, как управляющий блок std::shared_ptr;
+    // память элементов по-прежнему выделяет аллокатор вектора
+    template <typename... Args>
+    static Block* MakeBlock(Args&&... args) {
+        return new Block(std::forward<Args>(args)...);
+    }
+
+    static void ReleaseBlock(Block* block) noexcept {
+        if (block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete block;
+        }
+    }
+
+    // Делает буфер собственным (создаёт его или копирует разделённый) и возвращает его.
+    // Ссылка не выходит за пределы класса и Modify
+    Vector& Detached() {
+        if (block_ == nullptr) {
+            block_ = MakeBlock();
+        } else if (block_->refs.load(std::memory_order_acquire) != 1) {
+            Block* copy = MakeBlock(std::as_const(block_->data));
+            ReleaseBlock(std::exchange(block_, copy));
+        }
+        return block_->data;
+    }
+
+    Block* block_ = nullptr;
+};
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator==(const SharedSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.Get() == rhs.Get();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator!=(const SharedSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator<(const SharedSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.Get() < rhs.Get();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator<=(const SharedSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator>(const SharedSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator>=(const SharedSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,395 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "config.h"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define SIMPLE_VECTOR_SIMD_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SIMPLE_VECTOR_SIMD_NEON 1
+#endif
+
+// Векторизованные ядра сравнения и поиска для SimpleVector и родственных контейнеров.
+// Работают с непрерывными диапазонами; для типов, которые нельзя сравнивать побайтово,
+// используются обычные алгоритмы std. Набор инструкций выбирается при компиляции:
+// AVX2 (32 байта за шаг), SSE2 или NEON (16 байт), иначе — скалярный код.
+namespace simple_vector_simd {
+
+// Равенство значений совпадает с равенством их байтов: целые числа, перечисления, указатели.
+// Числа с плавающей точкой сюда не входят (0.0 == -0.0, NaN != NaN)
+template <typename Type>
+inline constexpr bool kIsBitwiseComparable =
+    std::is_integral_v<Type> || std::is_enum_v<Type> || std::is_pointer_v<Type>;
+
+namespace detail {
+
+#if defined(SIMPLE_VECTOR_SIMD_X86)
+
+#if defined(__AVX2__)
+using Vec = __m256i;
+inline constexpr size_t kVecBytes = 32;
+
+inline Vec Load(const void* ptr) noexcept {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(ptr));
+}
+
+template <size_t Size>
+inline Vec Splat(const void* value) noexcept {
+    if constexpr (Size == 1) {
+        int8_t v;
+        std::memcpy(&v, value, 1);
+        return _mm256_set1_epi8(v);
+    } else if constexpr (Size == 2) {
+        int16_t v;
+        std::memcpy(&v, value, 2);
+        return _mm256_set1_epi16(v);
+    } else if constexpr (Size == 4) {
+        int32_t v;
+        std::memcpy(&v, value, 4);
+        return _mm256_set1_epi32(v);
+    } else {
+        int64_t v;
+        std::memcpy(&v, value, 8);
+        return _mm256_set1_epi64x(v);
+    }
+}
+
+template <size_t Size>
+inline Vec CmpEq(Vec a, Vec b) noexcept {
+    if constexpr (Size == 1) {
+        return _mm256_cmpeq_epi8(a, b);
+    } else if constexpr (Size == 2) {
+        return _mm256_cmpeq_epi16(a, b);
+    } else if constexpr (Size == 4) {
+        return _mm256_cmpeq_epi32(a, b);
+    } else {
+        return _mm256_cmpeq_epi64(a, b);
+    }
+}
+
+// Маска совпавших байтов: по одному биту на байт
+inline uint64_t ByteMask(Vec v) noexcept {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+}
+#else
+using Vec = __m128i;
+inline constexpr size_t kVecBytes = 16;
+
+inline Vec Load(const void* ptr) noexcept {
+    return _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+}
+
+template <size_t Size>
+inline Vec Splat(const void* value) noexcept {
+    if constexpr (Size == 1) {
+        int8_t v;
+        std::memcpy(&v, value, 1);
+        return _mm_set1_epi8(v);
+    } else if constexpr (Size == 2) {
+        int16_t v;
+        std::memcpy(&v, value, 2);
+        return _mm_set1_epi16(v);
+    } else if constexpr (Size == 4) {
+        int32_t v;
+        std::memcpy(&v, value, 4);
+        return _mm_set1_epi32(v);
+    } else {
+        int64_t v;
+        std::memcpy(&v, value, 8);
+        return _mm_set1_epi64x(v);
+    }
+}
+
+template <size_t Size>
+inline Vec CmpEq(Vec a, Vec b) noexcept {
+    if constexpr (Size == 1) {
+        return _mm_cmpeq_epi8(a, b);
+    } else if constexpr (Size == 2) {
+        return _mm_cmpeq_epi16(a, b);
+    } else if constexpr (Size == 4) {
+        return _mm_cmpeq_epi32(a, b);
+    } else {
+        // в SSE2 нет сравнения 64-битных слов: обе 32-битные половины должны совпасть
+        const __m128i eq32 = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+}
+
+inline uint64_t ByteMask(Vec v) noexcept {
+    return static_cast<uint32_t>(_mm_movemask_epi8(v));
+}
+#endif
+
+// Сколько бит маски приходится на один байт
+inline constexpr size_t kMaskBitsPerByte = 1;
+
+#elif defined(SIMPLE_VECTOR_SIMD_NEON)
+
+using Vec = uint8x16_t;
+inline constexpr size_t kVecBytes = 16;
+
+inline Vec Load(const void* ptr) noexcept {
+    return vld1q_u8(static_cast<const uint8_t*>(ptr));
+}
+
+template <size_t Size>
+inline Vec Splat(const void* value) noexcept {
+    if constexpr (Size == 1) {
+        uint8_t v;
+        std::memcpy(&v, value, 1);
+        return vdupq_n_u8(v);
+    } else if constexpr (Size == 2) {
+        uint16_t v;
+        std::memcpy(&v, value, 2);
+        return vreinterpretq_u8_u16(vdupq_n_u16(v));
+    } else if constexpr (Size == 4) {
+        uint32_t v;
+        std::memcpy(&v, value, 4);
+        return vreinterpretq_u8_u32(vdupq_n_u32(v));
+    } else {
+        uint64_t v;
+        std::memcpy(&v, value, 8);
+        return vreinterpretq_u8_u64(vdupq_n_u64(v));
+    }
+}
+
+template <size_t Size>
+inline Vec CmpEq(Vec a, Vec b) noexcept {
+    if constexpr (Size == 1) {
+        return vceqq_u8(a, b);
+    } else if constexpr (Size == 2) {
+        return vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+    } else if constexpr (Size == 4) {
+        return vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+    } else {
+        const uint32x4_t eq32 = vceqq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b));
+        const uint32x4_t swapped = vrev64q_u32(eq32);
+        return vreinterpretq_u8_u32(vandq_u32(eq32, swapped));
+    }
+}
+
+// В NEON нет movemask: сужение сдвигом даёт по 4 бита на байт
+inline uint64_t ByteMask(Vec v) noexcept {
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+inline constexpr size_t kMaskBitsPerByte = 4;
+
+#endif
+
+#if defined(SIMPLE_VECTOR_SIMD_X86) || defined(SIMPLE_VECTOR_SIMD_NEON)
+#define SIMPLE_VECTOR_SIMD_ENABLED 1
+
+inline size_t CountTrailingZeros(uint64_t mask) noexcept {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_ctzll(mask));
+#else
+    size_t count = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+inline size_t PopCount(uint64_t mask) noexcept {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_popcountll(mask));
+#else
+    size_t count = 0;
+    for (; mask != 0; mask &= mask - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+inline uint64_t FullMask() noexcept {
+    constexpr size_t bits = kVecBytes * kMaskBitsPerByte;
+    return bits == 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+}
+#endif
+
+} // namespace detail
+
+// Возвращает индекс первого различающегося байта в a и b либо bytes, если различий нет
+inline size_t MismatchBytes(const void* a, const void* b, size_t bytes) noexcept {
+    const auto* lhs = static_cast<const unsigned char*>(a);
+    const auto* rhs = static_cast<const unsigned char*>(b);
+    size_t i = 0;
+#if defined(SIMPLE_VECTOR_SIMD_ENABLED)
+    using namespace detail;
+    for (; i + kVecBytes <= bytes; i += kVecBytes) {
+        const uint64_t equal = ByteMask(CmpEq<1>(Load(lhs + i), Load(rhs + i)));
+        if (equal != FullMask()) {
+            return i + CountTrailingZeros(~equal) / kMaskBitsPerByte;
+        }
+    }
+#endif
+    for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+        uint64_t x;
+        uint64_t y;
+        std::memcpy(&x, lhs + i, sizeof(x));
+        std::memcpy(&y, rhs + i, sizeof(y));
+        if (x != y) {
+            break;
+        }
+    }
+    for (; i < bytes; ++i) {
+        if (lhs[i] != rhs[i]) {
+            return i;
+        }
+    }
+    return bytes;
+}
+
+// Поэлементное равенство диапазонов [a, a + a_size) и [b, b + b_size)
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR bool Equal(const Type* a, size_t a_size, const Type* b, size_t b_size) {
+    if (a_size != b_size) {
+        return false;
+    }
+    if constexpr (kIsBitwiseComparable<Type>) {
+        if (!simple_vector_detail::IsConstantEvaluated()) {
+            return a_size == 0 || std::memcmp(a, b, a_size * sizeof(Type)) == 0;
+        }
+    }
+    return std::equal(a, a + a_size, b);
+}
+
+// Лексикографическое сравнение: для побайтово сравнимых типов сначала векторно
+// ищется первое несовпадение, затем сравнивается единственная пара элементов
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR bool Less(const Type* a, size_t a_size, const Type* b, size_t b_size) {
+    if constexpr (kIsBitwiseComparable<Type>) {
+        if (!simple_vector_detail::IsConstantEvaluated()) {
+            const size_t common = std::min(a_size, b_size);
+            if (common != 0) {
+                const size_t index = MismatchBytes(a, b, common * sizeof(Type)) / sizeof(Type);
+                if (index < common) {
+                    return a[index] < b[index];
+                }
+            }
+            return a_size < b_size;
+        }
+    }
+    return std::lexicographical_compare(a, a + a_size, b, b + b_size);
+}
+
+// Возвращает указатель на первый элемент, равный value, либо last
+template <typename Type>
+const Type* Find(const Type* first, const Type* last, const Type& value) {
+#if defined(SIMPLE_VECTOR_SIMD_ENABLED)
+    if constexpr (kIsBitwiseComparable<Type> && (sizeof(Type) == 1 || sizeof(Type) == 2
+                                                 || sizeof(Type) == 4 || sizeof(Type) == 8)) {
+        using namespace detail;
+        constexpr size_t per_vec = kVecBytes / sizeof(Type);
+        const Vec needle = Splat<sizeof(Type)>(&value);
+        for (; static_cast<size_t>(last - first) >= per_vec; first += per_vec) {
+            const uint64_t mask = ByteMask(CmpEq<sizeof(Type)>(Load(first), needle));
+            if (mask != 0) {
+                return first + CountTrailingZeros(mask) / (kMaskBitsPerByte * sizeof(Type));
+            }
+        }
+    }
+#endif
+    return std::find(first, last, value);
+}
+
+// Количество элементов, равных value
+template <typename Type>
+size_t Count(const Type* first, const Type* last, const Type& value) {
+    size_t count = 0;
+#if defined(SIMPLE_VECTOR_SIMD_ENABLED)
+    if constexpr (kIsBitwiseComparable<Type> && (sizeof(Type) == 1 || sizeof(Type) == 2
+                                                 || sizeof(Type) == 4 || sizeof(Type) == 8)) {
+        using namespace detail;
+        constexpr size_t per_vec = kVecBytes / sizeof(Type);
+        const Vec needle = Splat<sizeof(Type)>(&value);
+        for (; static_cast<size_t>(last - first) >= per_vec; first += per_vec) {
+            count += PopCount(ByteMask(CmpEq<sizeof(Type)>(Load(first), needle)));
+        }
+        count /= kMaskBitsPerByte * sizeof(Type);
+    }
+#endif
+    return count + static_cast<size_t>(std::count(first, last, value));
+}
+
+// Тип суммы: целые копятся в 64-битном целом той же знаковости, вещественные — в своём типе
+template <typename Type>
+using SumType = std::conditional_t<std::is_floating_point_v<Type>, Type,
+                                   std::conditional_t<std::is_signed_v<Type>, int64_t, uint64_t>>;
+
+// Количество независимых накопителей в редукциях: цепочки не зависят друг от друга,
+// и компилятор раскладывает их по дорожкам векторного регистра
+inline constexpr size_t kReductionLanes = 8;
+
+// Сумма элементов. Для вещественных порядок сложения отличается от последовательного
+template <typename Type>
+SumType<Type> Sum(const Type* first, const Type* last) {
+    static_assert(std::is_arithmetic_v<Type>, "Sum requires an arithmetic element type");
+    SumType<Type> lanes[kReductionLanes] = {};
+    const size_t size = static_cast<size_t>(last - first);
+    size_t i = 0;
+    for (; i + kReductionLanes <= size; i += kReductionLanes) {
+        for (size_t lane = 0; lane < kReductionLanes; ++lane) {
+            lanes[lane] += static_cast<SumType<Type>>(first[i + lane]);
+        }
+    }
+    SumType<Type> total{};
+    for (; i < size; ++i) {
+        total += static_cast<SumType<Type>>(first[i]);
+    }
+    for (size_t lane = 0; lane < kReductionLanes; ++lane) {
+        total += lanes[lane];
+    }
+    return total;
+}
+
+// Минимальный и максимальный элементы непустого диапазона
+template <typename Type>
+std::pair<Type, Type> MinMax(const Type* first, const Type* last) {
+    assert(first != last);
+    if constexpr (std::is_arithmetic_v<Type>) {
+        Type lo[kReductionLanes];
+        Type hi[kReductionLanes];
+        std::fill(std::begin(lo), std::end(lo), *first);
+        std::fill(std::begin(hi), std::end(hi), *first);
+        const size_t size = static_cast<size_t>(last - first);
+        size_t i = 0;
+        for (; i + kReductionLanes <= size; i += kReductionLanes) {
+            for (size_t lane = 0; lane < kReductionLanes; ++lane) {
+                const Type value = first[i + lane];
+                lo[lane] = value < lo[lane] ? value : lo[lane];
+                hi[lane] = hi[lane] < value ? value : hi[lane];
+            }
+        }
+        Type min_value = *first;
+        Type max_value = *first;
+        for (; i < size; ++i) {
+            min_value = first[i] < min_value ? first[i] : min_value;
+            max_value = max_value < first[i] ? first[i] : max_value;
+        }
+        for (size_t lane = 0; lane < kReductionLanes; ++lane) {
+            min_value = lo[lane] < min_value ? lo[lane] : min_value;
+            max_value = max_value < hi[lane] ? hi[lane] : max_value;
+        }
+        return {min_value, max_value};
+    } else {
+        const auto [min_it, max_it] = std::minmax_element(first, last);
+        return {*min_it, *max_it};
+    }
+}
+
+} // namespace simple_vector_simd
@@ -4,221 +4,489 @@
 #include <cassert>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
+#include <utility>
 
+#include "aligned_allocator.h"
+#include "arena.h"
+#include "config.h"
 #include "array_ptr.h"
- 
+#include "growth_policy.h"
+#include "simd.h"
+#include "stats.h"
+#include "uninitialized.h"
+
 // Обёртка для скрытия реального конструктора с резервированием.
 struct ReserveProxyObj {
     size_t capacity_to_reserve_;
-    ReserveProxyObj(size_t capacity_to_reserve) : capacity_to_reserve_(capacity_to_reserve) {}
+    constexpr ReserveProxyObj(size_t capacity_to_reserve) : capacity_to_reserve_(capacity_to_reserve) {}
 };
 
-ReserveProxyObj Reserve(size_t capacity_to_reserve) {
+constexpr ReserveProxyObj Reserve(size_t capacity_to_reserve) {
     return ReserveProxyObj(capacity_to_reserve);
 }
- 
+
+// Тег конструктора, создающего элементы инициализацией по умолчанию:
+// SimpleVector<uint8_t> buffer(size, DefaultInit) не обнуляет память
+struct DefaultInitTag {
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag DefaultInit{};
+
+// Буфер, отданный вектором через Release(): элементы [data, data + size) созданы,
+// память рассчитана на capacity элементов
 template <typename Type>
+struct SimpleVectorBuffer {
+    Type* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+// GrowthPolicy задаёт, во сколько раз растёт вместимость при нехватке места (см. growth_policy.h)
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
 class SimpleVector {
- 
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
     using Iterator = Type*;
     using ConstIterator = const Type*;
- 
-    SimpleVector() noexcept = default;
- 
+    using allocator_type = Allocator;
+
+    SimpleVector() noexcept(noexcept(Allocator())) = default;
+
+    // Создаёт пустой вектор, который будет выделять память аллокатором alloc
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(const Allocator& alloc) noexcept : items_(alloc) {}
+
     // Создаёт вектор из size элементов, инициализированных значением по умолчанию
-    explicit SimpleVector(size_t size) : SimpleVector(size, std::move(Type())) {}
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(size_t size, const Allocator& alloc = Allocator()) : items_(size, alloc) {
+        simple_vector_detail::UninitializedValueConstruct(items_.GetAllocator(), items_.Get(), size);
+        size_ = size;
+    }
 
-    // Создаёт вектор из size элементов, инициализированных значением value
-    SimpleVector(size_t size, const Type &value) : items_(size), size_(size), capacity_(size) {
-        std::fill(begin(), end(), value);
+    // Создаёт вектор из size элементов, инициализированных по умолчанию (new Type без скобок).
+    // Значения тривиальных типов остаются неопределёнными: память нужно заполнить до чтения
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(size_t size, DefaultInitTag, const Allocator& alloc = Allocator()) : items_(size, alloc) {
+        simple_vector_detail::UninitializedDefaultConstruct(items_.GetAllocator(), items_.Get(), size);
+        size_ = size;
     }
 
-    SimpleVector(size_t size, Type &&value) : items_(size), size_(size), capacity_(size) {
-        for (size_t i = 0; i < size_; ++i)
-        {
-            items_[i] = std::move(value);
-        }
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(size_t size, const Type &value, const Allocator& alloc = Allocator()) : items_(size, alloc) {
+        simple_vector_detail::UninitializedFill(items_.GetAllocator(), items_.Get(), size, value);
+        size_ = size;
     }
 
-    // Конструктор, который будет сразу резервировать нужное количество памяти
-    SimpleVector(ReserveProxyObj obj) {
-    	Reserve(obj.capacity_to_reserve_);
+    // Конструктор, который будет сразу резервировать нужное количество памяти.
+    // Элементы в зарезервированной памяти не создаются
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(ReserveProxyObj obj, const Allocator& alloc = Allocator()) : items_(obj.capacity_to_reserve_, alloc) {
     }
 
     // Создаёт вектор из std::initializer_list
-    SimpleVector(std::initializer_list<Type> init) : items_(init.size()), size_(init.size()), capacity_(init.size()) {
-        std::copy(init.begin(), init.end(), begin());
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator()) : items_(init.size(), alloc) {
+        simple_vector_detail::UninitializedCopy(items_.GetAllocator(), init.begin(), init.end(), items_.Get());
+        size_ = init.size();
     }
 
-    // Конструктор копирования. 
+    // Конструктор копирования.
     // Копия вектора должна иметь вместимость, достаточную для хранения копии элементов исходного вектора
-    SimpleVector(const SimpleVector &other) : items_(other.capacity_), size_(other.size_), capacity_(other.capacity_) {
-        std::copy(other.begin(), other.end(), begin());
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector &other)
+        : SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.items_.GetAllocator())) {
+    }
+
+    // Конструктор копирования с явно заданным аллокатором
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector &other, const Allocator& alloc) : items_(other.GetCapacity(), alloc) {
+        simple_vector_detail::UninitializedCopy(items_.GetAllocator(), other.begin(), other.end(), items_.Get());
+        size_ = other.size_;
     }
-    
-    // Конструктор перемещения
-    SimpleVector(SimpleVector &&other) {
-    	items_ = std::move(other.items_);
-    	size_ = std::move(other.size_);
-    	capacity_ = size_;
-    	other.size_ = 0;
-    	other.capacity_ = 0;
+
+    // Конструктор перемещения. Не бросает исключений, поэтому контейнеры из SimpleVector
+    // (например, std::vector<SimpleVector<T>>) при росте перемещают, а не копируют элементы
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(SimpleVector &&other) noexcept : items_(std::move(other.items_)), size_(std::exchange(other.size_, 0)) {
+    }
+
+    // Конструктор перемещения с явно заданным аллокатором.
+    // Если аллокаторы не равны, элементы перемещаются по одному в память аллокатора alloc
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(SimpleVector &&other, const Allocator& alloc) : items_(alloc) {
+        if (items_.GetAllocator() == other.items_.GetAllocator()) {
+            items_ = std::move(other.items_);
+            size_ = std::exchange(other.size_, 0);
+        } else {
+            ArrayPtr<Type, Allocator> temp(other.GetCapacity(), alloc);
+            simple_vector_detail::UninitializedMove(temp.GetAllocator(), other.begin(), other.end(), temp.Get());
+            items_.swap(temp);
+            size_ = other.size_;
+            other.Clear();
+        }
+    }
+
+    // Разрушает созданные элементы [0, size_); память освобождает ArrayPtr
+    SIMPLE_VECTOR_CONSTEXPR ~SimpleVector() {
+        RecordRelease();
+        simple_vector_detail::DestroyRange(items_.GetAllocator(), begin(), end());
     }
 
     // Оператор присваивания.
     // Должен обеспечивать строгую гарантию безопасности исключений.
-    SimpleVector& operator=(const SimpleVector& rhs) {
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(const SimpleVector& rhs) {
         if (this != &rhs)
         {
-            SimpleVector<Type> temp(rhs);
-            swap(temp);
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                *this = SimpleVector(rhs, rhs.items_.GetAllocator());
+            } else {
+                *this = SimpleVector(rhs, items_.GetAllocator());
+            }
         }
         return *this;
     }
 
-    SimpleVector& operator=(SimpleVector&& rhs) {
+    // Прежние элементы разрушаются.
+    // Если аллокатор не распространяется при перемещении и не равен аллокатору rhs,
+    // элементы rhs перемещаются по одному в память текущего аллокатора
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(SimpleVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                     || AllocTraits::is_always_equal::value) {
         if (this != &rhs)
         {
+            if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                          && !AllocTraits::is_always_equal::value) {
+                if (items_.GetAllocator() != rhs.items_.GetAllocator()) {
+                    SimpleVector temp(std::move(rhs), items_.GetAllocator());
+                    swap(temp);
+                    return *this;
+                }
+            }
+            RecordRelease();
+            Clear();
             items_ = std::move(rhs.items_);
-            std::swap(size_, rhs.size_);
-            std::swap(capacity_, rhs.capacity_);
-            rhs.size_ = 0;
-            rhs.capacity_ = 0;
+            size_ = std::exchange(rhs.size_, 0);
         }
         return *this;
     }
 
+    // Возвращает копию аллокатора вектора
+    SIMPLE_VECTOR_CONSTEXPR Allocator GetAllocator() const noexcept {
+        return items_.GetAllocator();
+    }
+
+    // Принимает во владение без копирования буфер ptr на capacity элементов, в начале которого
+    // уже созданы size элементов. Память должна быть выделена аллокатором, равным аллокатору
+    // вектора (например, получена из Release()). Прежние элементы разрушаются, буфер освобождается
+    SIMPLE_VECTOR_CONSTEXPR void Adopt(Type* ptr, size_t size, size_t capacity) noexcept {
+        assert(size <= capacity && (ptr != nullptr || capacity == 0));
+        ArrayPtr<Type, Allocator> adopted(ptr, capacity, items_.GetAllocator());
+        ReplaceBuffer(adopted, size);
+    }
+
+    // Принимает чужой буфер (сетевого стека, распаковщика, C API): память освободит
+    // deleter(ptr, capacity) или deleter(ptr). Если вектору понадобится больше места, элементы
+    // переедут в память аллокатора, а буфер сразу вернётся через deleter.
+    // Если не удалось выделить место под deleter, вектор и буфер не меняются
+    template <typename Deleter>
+    void Adopt(Type* ptr, size_t size, size_t capacity, Deleter deleter) {
+        assert(size <= capacity && (ptr != nullptr || capacity == 0));
+        using Impl = simple_vector_detail::BufferDeleterImpl<Type, Deleter>;
+        ArrayPtr<Type, Allocator> adopted(ptr, capacity, std::make_unique<Impl>(std::move(deleter)), items_.GetAllocator());
+        ReplaceBuffer(adopted, size);
+    }
+
+    // Отдаёт буфер без копирования: {указатель, размер, вместимость}. Вектор остаётся пустым без буфера.
+    // Разрушить элементы и освободить память должен вызывающий: аллокатором вектора или,
+    // если буфер был принят через Adopt с deleter и с тех пор не перевыделялся, как принято у его хозяина
+    [[nodiscard]] SIMPLE_VECTOR_CONSTEXPR SimpleVectorBuffer<Type> Release() noexcept {
+        const SimpleVectorBuffer<Type> buffer{items_.Get(), size_, GetCapacity()};
+        static_cast<void>(items_.Release());
+        size_ = 0;
+        return buffer;
+    }
+
     // Задает ёмкость вектора
     // Если new_capacity больше текущей capacity, память должна быть перевыделена,
-    // а элементы вектора скопированы в новый отрезок памяти.
-    void Reserve(size_t new_capacity) {
-    	if (new_capacity > capacity_) {
-            ArrayPtr<Type> temp(new_capacity);
-            std::copy(std::make_move_iterator(begin()), std::make_move_iterator(end()), temp.Get());
-            items_.swap(temp);
-            capacity_ = new_capacity;
+    // а элементы вектора перемещены в новый отрезок памяти.
+    // Если перемещение Type может бросить исключение, элементы копируются:
+    // при исключении вектор остаётся прежним (строгая гарантия)
+    SIMPLE_VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
+    	if (new_capacity > GetCapacity()) {
+            Reallocate(new_capacity);
     	}
     }
 
+    // Уменьшает вместимость до текущего размера, возвращая лишнюю память аллокатору.
+    // Пустой вектор освобождает буфер целиком
+    SIMPLE_VECTOR_CONSTEXPR void ShrinkToFit() {
+        if (size_ == GetCapacity()) {
+            return;
+        }
+        if (size_ == 0) {
+            RecordRelease();
+            items_ = ArrayPtr<Type, Allocator>(items_.GetAllocator());
+            return;
+        }
+        Reallocate(size_);
+    }
+
     // Добавляет элемент в конец вектора
-    // При нехватке места увеличивает вдвое вместимость вектора
-    void PushBack(const Type& item) {
-        auto index = size_;
-        if (size_ == capacity_) {
-            Resize(capacity_ + 1);
-        } else {
+    // При нехватке места увеличивает вместимость по политике GrowthPolicy (по умолчанию вдвое)
+    SIMPLE_VECTOR_CONSTEXPR void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Вставляет значение value в позицию pos.
+    // Возвращает итератор на вставленное значение
+    // Если перед вставкой значения вектор был заполнен полностью, вместимость растёт
+    // по политике GrowthPolicy (по умолчанию вдвое, а для вектора вместимостью 0 становится равной 1)
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, const Type &value) {
+        return Emplace(pos, value);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент в конце вектора из аргументов args прямо в памяти вектора.
+    // Возвращает ссылку на созданный элемент.
+    // При перевыделении новый элемент создаётся раньше переноса старых,
+    // поэтому аргументы могут ссылаться на элементы самого вектора
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR Type& EmplaceBack(Args&&... args) {
+        if (size_ < GetCapacity() || items_.TryExpand(NextCapacity(size_ + 1))) {
+            simple_vector_detail::ConstructAt(items_.GetAllocator(), end(), std::forward<Args>(args)...);
             ++size_;
+            return *(end() - 1);
+        }
+        ArrayPtr<Type, Allocator> temp(NextCapacity(size_ + 1), items_.GetAllocator());
+        auto& alloc = temp.GetAllocator();
+        simple_vector_detail::ConstructAt(alloc, temp.Get() + size_, std::forward<Args>(args)...);
+        try {
+            simple_vector_detail::RelocateRange(alloc, begin(), end(), temp.Get());
+        } catch (...) {
+            simple_vector_detail::DestroyAt(alloc, temp.Get() + size_);
+            throw;
         }
-        items_[index] = item;
+        RecordReallocation();
+        items_.swap(temp);
+        ++size_;
+        return *(end() - 1);
     }
 
-    void PushBack(Type&& item) {
-        auto index = size_;
-        if (size_ == capacity_) {
-            Resize(capacity_ + 1);
+    // Создаёт элемент из аргументов args в позиции pos. Возвращает итератор на него.
+    // При вставке в конец или с перевыделением элемент создаётся сразу на своём месте
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        const size_t index = static_cast<size_t>(pos - begin());
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+        } else if (size_ < GetCapacity() || items_.TryExpand(NextCapacity(size_ + 1))) {
+            // аргументы могут ссылаться на сдвигаемый элемент, поэтому сначала создаём значение
+            Type temp_value(std::forward<Args>(args)...);
+            if constexpr (kIsTriviallyRelocatable<Type>) {
+                // освободить позицию index одним memmove и создать в ней новый элемент
+                Iterator hole = begin() + index;
+                simple_vector_detail::RelocateOverlapping(hole, end(), hole + 1);
+                try {
+                    simple_vector_detail::ConstructAt(items_.GetAllocator(), hole, std::move(temp_value));
+                } catch (...) {
+                    simple_vector_detail::RelocateOverlapping(hole + 1, end() + 1, hole);
+                    throw;
+                }
+                ++size_;
+            } else {
+                simple_vector_detail::ConstructAt(items_.GetAllocator(), end(), std::move(items_[size_ - 1]));
+                ++size_;
+                std::move_backward(begin() + index, end() - 2, end() - 1);
+                items_[index] = std::move(temp_value);
+            }
         } else {
+            ArrayPtr<Type, Allocator> temp(NextCapacity(size_ + 1), items_.GetAllocator());
+            auto& alloc = temp.GetAllocator();
+            simple_vector_detail::ConstructAt(alloc, temp.Get() + index, std::forward<Args>(args)...);
+            if constexpr (kIsTriviallyRelocatable<Type>) {
+                simple_vector_detail::RelocateRange(alloc, begin(), begin() + index, temp.Get());
+                simple_vector_detail::RelocateRange(alloc, begin() + index, end(), temp.Get() + index + 1);
+            } else {
+                try {
+                    simple_vector_detail::UninitializedMoveIfNoexcept(alloc, begin(), begin() + index, temp.Get());
+                    try {
+                        simple_vector_detail::UninitializedMoveIfNoexcept(alloc, begin() + index, end(), temp.Get() + index + 1);
+                    } catch (...) {
+                        simple_vector_detail::DestroyRange(alloc, temp.Get(), temp.Get() + index);
+                        throw;
+                    }
+                } catch (...) {
+                    simple_vector_detail::DestroyAt(alloc, temp.Get() + index);
+                    throw;
+                }
+                simple_vector_detail::DestroyRange(items_.GetAllocator(), begin(), end());
+            }
+            RecordReallocation();
+            items_.swap(temp);
             ++size_;
         }
-        items_[index] = std::move(item);
+        return begin() + index;
     }
 
-    // Вставляет значение value в позицию pos.
-    // Возвращает итератор на вставленное значение
-    // Если перед вставкой значения вектор был заполнен полностью,
-    // вместимость вектора должна увеличиться вдвое, а для вектора вместимостью 0 стать равной 1
-    Iterator Insert(ConstIterator pos, const Type &value) {
+    // Вставляет копии элементов [first, last) в позицию pos. Возвращает итератор на первый вставленный.
+    // Для прямых итераторов память резервируется один раз и хвост сдвигается один раз,
+    // непрерывные диапазоны тривиально копируемых типов копируются одним memcpy.
+    // Диапазон не должен ссылаться на элементы самого вектора
+    template <typename InputIt, typename = std::enable_if_t<simple_vector_detail::IsInputIterator<InputIt>::value>>
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
         assert(pos >= begin() && pos <= end());
-        auto index = pos - begin();
-        if (size_ < capacity_) {
-            std::copy_backward(std::make_move_iterator(begin() + index), std::make_move_iterator(end()), end() + 1);
-        	items_[index] = value;
-        	++size_;
+        if constexpr (simple_vector_detail::IsForwardIterator<InputIt>::value) {
+            return InsertRange(pos, first, static_cast<size_t>(std::distance(first, last)));
         } else {
-            // новую вместимость SimpleVector можно выбрать как максимум из 1 (для пустого вектора) и capacity_ * 2
-        	SimpleVector<Type> temp(std::max(capacity_ * 2, static_cast<size_t>(1)));
-        	temp.size_ = size_ + 1;
-        	std::copy(std::make_move_iterator(begin()), std::make_move_iterator(begin() + index), temp.begin());
-        	temp[index] = value;
-        	std::copy(std::make_move_iterator(begin() + index), std::make_move_iterator(end()), temp.begin() + index + 1);
-    	    swap(temp);
+            // однопроходный диапазон: в конец добавляем сразу, иначе сначала собираем во временный вектор
+            const size_t index = static_cast<size_t>(pos - begin());
+            if (index == size_) {
+                for (; first != last; ++first) {
+                    EmplaceBack(*first);
+                }
+                return begin() + index;
+            }
+            SimpleVector temp(items_.GetAllocator());
+            for (; first != last; ++first) {
+                temp.EmplaceBack(*first);
+            }
+            return InsertRange(pos, std::make_move_iterator(temp.begin()), temp.GetSize());
         }
-        return begin() + index;
     }
 
-    Iterator Insert(ConstIterator pos, Type&& value) {
+    // Вставляет count копий value в позицию pos. Возвращает итератор на первую вставленную копию
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, size_t count, const Type& value) {
         assert(pos >= begin() && pos <= end());
-        auto index = pos - begin();
-        if (size_ < capacity_) {
-            std::copy_backward(std::make_move_iterator(begin() + index), std::make_move_iterator(end()), end() + 1);
-        	items_[index] = std::move(value);
-        	++size_;
+        // value может ссылаться на сдвигаемый элемент
+        const Type copy(value);
+        return InsertRange(pos, simple_vector_detail::RepeatIterator<Type>(&copy, 0), count);
+    }
+
+    // Добавляет копии элементов [first, last) в конец вектора
+    template <typename InputIt, typename = std::enable_if_t<simple_vector_detail::IsInputIterator<InputIt>::value>>
+    SIMPLE_VECTOR_CONSTEXPR void Append(InputIt first, InputIt last) {
+        Insert(end(), first, last);
+    }
+
+    // Заменяет содержимое вектора копиями элементов [first, last).
+    // Для прямых итераторов вместимость увеличивается не более одного раза — ровно до размера диапазона
+    template <typename InputIt, typename = std::enable_if_t<simple_vector_detail::IsInputIterator<InputIt>::value>>
+    SIMPLE_VECTOR_CONSTEXPR void Assign(InputIt first, InputIt last) {
+        if constexpr (simple_vector_detail::IsForwardIterator<InputIt>::value) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (count > GetCapacity()) {
+                ArrayPtr<Type, Allocator> temp(count, items_.GetAllocator());
+                simple_vector_detail::UninitializedCopy(temp.GetAllocator(), first, last, temp.Get());
+                RecordRelease();
+                Clear();
+                items_.swap(temp);
+                size_ = count;
+                return;
+            }
+            // переприсвоить существующие элементы, оставшиеся создать или разрушить
+            const size_t common = std::min(count, size_);
+            InputIt mid = std::next(first, static_cast<std::ptrdiff_t>(common));
+            std::copy(first, mid, begin());
+            if (count > size_) {
+                simple_vector_detail::UninitializedCopy(items_.GetAllocator(), mid, last, end());
+            } else {
+                simple_vector_detail::DestroyRange(items_.GetAllocator(), begin() + count, end());
+            }
+            size_ = count;
         } else {
-            // новую вместимость SimpleVector можно выбрать как максимум из 1 (для пустого вектора) и capacity_ * 2
-        	SimpleVector<Type> temp(std::max(capacity_ * 2, static_cast<size_t>(1)));
-        	temp.size_ = size_ + 1;
-        	std::copy(std::make_move_iterator(begin()), std::make_move_iterator(begin() + index), temp.begin());
-        	temp[index] = std::move(value);
-        	std::copy(std::make_move_iterator(begin() + index), std::make_move_iterator(end()), temp.begin() + index + 1);
-    	    swap(temp);
+            Clear();
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
         }
-        return begin() + index;
     }
 
-    // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
-    void PopBack() noexcept {
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
+    SIMPLE_VECTOR_CONSTEXPR void PopBack() noexcept {
         if (!IsEmpty()) {
             --size_;
+            simple_vector_detail::DestroyAt(items_.GetAllocator(), end());
         }
     }
 
-    // Удаляет элемент вектора в указанной позиции
-    Iterator Erase(ConstIterator pos) {
+    // Удаляет элемент вектора в указанной позиции.
+    // Хвост тривиально перемещаемых типов сдвигается одним memmove
+    SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator pos) {
         assert(pos >= begin() && pos < end());
         auto index = pos - begin();
-        std::copy(std::make_move_iterator(begin() + index + 1), std::make_move_iterator(end()), begin() + index);
-        --size_;
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            Iterator erased = begin() + index;
+            simple_vector_detail::DestroyAt(items_.GetAllocator(), erased);
+            simple_vector_detail::RelocateOverlapping(erased + 1, end(), erased);
+            --size_;
+        } else {
+            std::move(begin() + index + 1, end(), begin() + index);
+            PopBack();
+        }
         return begin() + index;
     }
-	
+
+    // Удаляет элементы [first, last). Хвост сдвигается один раз.
+    // Возвращает итератор на элемент, следующий за удалёнными
+    SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(begin() <= first && first <= last && last <= end());
+        const size_t index = static_cast<size_t>(first - begin());
+        const size_t count = static_cast<size_t>(last - first);
+        if (count == 0) {
+            return begin() + index;
+        }
+        Iterator erased = begin() + index;
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            simple_vector_detail::DestroyRange(items_.GetAllocator(), erased, erased + count);
+            simple_vector_detail::RelocateOverlapping(erased + count, end(), erased);
+        } else {
+            std::move(erased + count, end(), erased);
+            simple_vector_detail::DestroyRange(items_.GetAllocator(), end() - count, end());
+        }
+        size_ -= count;
+        return erased;
+    }
+
     // Обменивает значение с другим вектором
-    void swap(SimpleVector& other) noexcept {
+    SIMPLE_VECTOR_CONSTEXPR void swap(SimpleVector& other) noexcept {
     	items_.swap(other.items_);
     	std::swap(size_, other.size_);
-    	std::swap(capacity_, other.capacity_);
     }
-    
+
     // Возвращает количество элементов в массиве
-    size_t GetSize() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
     	return size_;
     }
 
     // Возвращает вместимость массива
-    size_t GetCapacity() const noexcept {
-    	return capacity_;
+    SIMPLE_VECTOR_CONSTEXPR size_t GetCapacity() const noexcept {
+    	return items_.GetSize();
     }
-    
+
     // Сообщает, пустой ли массив
-    bool IsEmpty() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR bool IsEmpty() const noexcept {
         return !GetSize();
     }
 
     // Возвращает ссылку на элемент с индексом index
-    Type& operator[](size_t index) noexcept {
+    SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept {
         assert(index < size_);
     	return items_[index];
     }
 
     // Возвращает константную ссылку на элемент с индексом index
-    const Type& operator[](size_t index) const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept {
         assert(index < size_);
     	return items_[index];
     }
-    
+
     // Возвращает константную ссылку на элемент с индексом index
     // Выбрасывает исключение std::out_of_range, если index >= size
-    Type& At(size_t index) {
+    SIMPLE_VECTOR_CONSTEXPR Type& At(size_t index) {
         if (index >= size_) {
             throw std::out_of_range("out of range");
         }
@@ -227,115 +495,288 @@ public:
 
     // Возвращает константную ссылку на элемент с индексом index
     // Выбрасывает исключение std::out_of_range, если index >= size
-    const Type& At(size_t index) const {
+    SIMPLE_VECTOR_CONSTEXPR const Type& At(size_t index) const {
         if (index >= size_) {
             throw std::out_of_range("out of range");
         }
         return items_[index];
     }
 
-    // Обнуляет размер массива, не изменяя его вместимость
-    void Clear() noexcept {
+    // Возвращает итератор на первый элемент, равный value, либо end()
+    Iterator Find(const Type& value) {
+        return begin() + (simple_vector_simd::Find(cbegin(), cend(), value) - cbegin());
+    }
+
+    ConstIterator Find(const Type& value) const {
+        return simple_vector_simd::Find(cbegin(), cend(), value);
+    }
+
+    // Возвращает количество элементов, равных value
+    size_t Count(const Type& value) const {
+        return simple_vector_simd::Count(cbegin(), cend(), value);
+    }
+
+    // Сообщает, есть ли в массиве элемент, равный value
+    bool Contains(const Type& value) const {
+        return Find(value) != cend();
+    }
+
+    // Возвращает пару из минимального и максимального элементов.
+    // Массив не должен быть пустым
+    std::pair<Type, Type> MinMax() const {
+        assert(!IsEmpty());
+        return simple_vector_simd::MinMax(cbegin(), cend());
+    }
+
+    // Возвращает сумму элементов арифметического типа (целые суммируются в 64-битном типе)
+    simple_vector_simd::SumType<Type> Sum() const noexcept {
+        return simple_vector_simd::Sum(cbegin(), cend());
+    }
+
+    // Обнуляет размер массива, не изменяя его вместимость.
+    // Элементы разрушаются
+    SIMPLE_VECTOR_CONSTEXPR void Clear() noexcept {
+        simple_vector_detail::DestroyRange(items_.GetAllocator(), begin(), end());
     	size_ = 0;
     }
 
     // Изменяет размер массива.
     // При увеличении размера новые элементы получают значение по умолчанию для типа Type
-    void Resize(size_t new_size) {
-    	if (new_size <= capacity_) {
-        	if (new_size <= size_) {
-                // сжать вектор, уменьшается размер, элементы остаются в памяти
-        	    size_ = new_size;
-        	} else {
-                // заполнить свободные элементы по умолчанию Type{}
-        	    for (size_t i = size_; i < new_size; ++i) {
-                    items_[i] = std::move(Type());
-                }
-                size_ = new_size;
-        	}
-    	} else {
-            // увеличить вместимость
-            // новую вместимость SimpleVector можно выбрать как максимум из new_capacity и capacity_ * 2.
-            capacity_ = std::max(new_size, capacity_ * 2);
-            ArrayPtr<Type> temp(capacity_);
-            std::copy(std::make_move_iterator(begin()), std::make_move_iterator(end()), temp.Get());
-            for (size_t i = size_; i < new_size; ++i) {
-                temp[i] = std::move(Type());
-            }
-            items_.swap(temp);
+    SIMPLE_VECTOR_CONSTEXPR void Resize(size_t new_size) {
+    	if (new_size <= size_) {
+            // сжать вектор: лишние элементы разрушаются, вместимость не меняется
+            simple_vector_detail::DestroyRange(items_.GetAllocator(), begin() + new_size, end());
             size_ = new_size;
+            return;
     	}
+    	if (new_size > GetCapacity()) {
+            // увеличить вместимость по политике роста
+            Reallocate(NextCapacity(new_size));
+    	}
+        // сконструировать новые элементы значением по умолчанию Type{}
+        simple_vector_detail::UninitializedValueConstruct(items_.GetAllocator(), end(), new_size - size_);
+        size_ = new_size;
+    }
+
+    // Изменяет размер массива как Resize, но новые элементы инициализируются по умолчанию:
+    // у тривиальных типов (uint8_t, float, POD-структуры) память не обнуляется.
+    // Предназначен для буферов, которые сразу заполняются, например чтением из файла
+    SIMPLE_VECTOR_CONSTEXPR void ResizeDefaultInit(size_t new_size) {
+        if (new_size <= size_) {
+            Resize(new_size);
+            return;
+        }
+        if (new_size > GetCapacity()) {
+            Reallocate(NextCapacity(new_size));
+        }
+        simple_vector_detail::UninitializedDefaultConstruct(items_.GetAllocator(), end(), new_size - size_);
+        size_ = new_size;
     }
 
     // Возвращает итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
-    Iterator begin() noexcept {
+    SIMPLE_VECTOR_CONSTEXPR Iterator begin() noexcept {
         return items_.Get();
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
-    Iterator end() noexcept {
+    SIMPLE_VECTOR_CONSTEXPR Iterator end() noexcept {
         // Напишите тело самостоятельно
         return items_.Get() + size_;
     }
 
     // Возвращает константный итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator begin() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator begin() const noexcept {
         return items_.Get();
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator end() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator end() const noexcept {
         return items_.Get() + size_;
     }
 
     // Возвращает константный итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator cbegin() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cbegin() const noexcept {
         return items_.Get();
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator cend() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cend() const noexcept {
         return items_.Get() + size_;
     }
 
 private:
-    ArrayPtr<Type> items_;
+    // Вместимость, до которой нужно вырасти, чтобы вместить required элементов
+    SIMPLE_VECTOR_CONSTEXPR size_t NextCapacity(size_t required) const {
+        const size_t max_size = AllocTraits::max_size(items_.GetAllocator());
+        if (required > max_size) {
+            throw std::length_error("SimpleVector is too long");
+        }
+        const size_t next = GrowthPolicy::NextCapacity(GetCapacity(), required, sizeof(Type));
+        return std::clamp(next, required, max_size);
+    }
+
+    // Вставляет count элементов из прямого итератора first в позицию pos.
+    // Память выделяется не более одного раза, хвост сдвигается один раз
+    template <typename ForwardIt>
+    SIMPLE_VECTOR_CONSTEXPR Iterator InsertRange(ConstIterator pos, ForwardIt first, size_t count) {
+        const size_t index = static_cast<size_t>(pos - begin());
+        if (count == 0) {
+            return begin() + index;
+        }
+        auto& alloc = items_.GetAllocator();
+        if (size_ + count <= GetCapacity() || items_.TryExpand(NextCapacity(size_ + count))) {
+            Iterator hole = begin() + index;
+            const size_t tail = size_ - index;
+            if constexpr (kIsTriviallyRelocatable<Type>) {
+                // освободить место одним memmove и создать элементы прямо в нём
+                simple_vector_detail::RelocateOverlapping(hole, end(), hole + count);
+                try {
+                    simple_vector_detail::UninitializedCopy(alloc, first, std::next(first, static_cast<std::ptrdiff_t>(count)), hole);
+                } catch (...) {
+                    simple_vector_detail::RelocateOverlapping(hole + count, end() + count, hole);
+                    throw;
+                }
+                size_ += count;
+            } else if (tail > count) {
+                // последние count элементов хвоста переезжают в неинициализированную память,
+                // остальные сдвигаются присваиванием, на освободившееся место копируется диапазон
+                Iterator old_end = end();
+                simple_vector_detail::UninitializedMove(alloc, old_end - count, old_end, old_end);
+                size_ += count;
+                std::move_backward(hole, old_end - count, old_end);
+                std::copy_n(first, count, hole);
+            } else {
+                // часть диапазона, не помещающаяся над хвостом, создаётся в неинициализированной памяти
+                Iterator old_end = end();
+                ForwardIt mid = std::next(first, static_cast<std::ptrdiff_t>(tail));
+                simple_vector_detail::UninitializedCopy(alloc, mid, std::next(mid, static_cast<std::ptrdiff_t>(count - tail)), old_end);
+                size_ += count - tail;
+                simple_vector_detail::UninitializedMove(alloc, hole, old_end, hole + count);
+                size_ += tail;
+                std::copy(first, mid, hole);
+            }
+            return begin() + index;
+        }
+        // новый буфер: диапазон создаётся сразу на своём месте, затем переносятся старые элементы
+        ArrayPtr<Type, Allocator> temp(NextCapacity(size_ + count), alloc);
+        auto& temp_alloc = temp.GetAllocator();
+        Type* inserted = temp.Get() + index;
+        simple_vector_detail::UninitializedCopy(temp_alloc, first, std::next(first, static_cast<std::ptrdiff_t>(count)), inserted);
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            simple_vector_detail::RelocateRange(temp_alloc, begin(), begin() + index, temp.Get());
+            simple_vector_detail::RelocateRange(temp_alloc, begin() + index, end(), inserted + count);
+        } else {
+            try {
+                simple_vector_detail::UninitializedMoveIfNoexcept(temp_alloc, begin(), begin() + index, temp.Get());
+                try {
+                    simple_vector_detail::UninitializedMoveIfNoexcept(temp_alloc, begin() + index, end(), inserted + count);
+                } catch (...) {
+                    simple_vector_detail::DestroyRange(temp_alloc, temp.Get(), inserted);
+                    throw;
+                }
+            } catch (...) {
+                simple_vector_detail::DestroyRange(temp_alloc, inserted, inserted + count);
+                throw;
+            }
+            simple_vector_detail::DestroyRange(alloc, begin(), end());
+        }
+        RecordReallocation();
+        items_.swap(temp);
+        size_ += count;
+        return begin() + index;
+    }
+
+    // Разрушает элементы и заменяет буфер на buffer с size созданными элементами.
+    // Прежний буфер освобождается вместе с buffer
+    SIMPLE_VECTOR_CONSTEXPR void ReplaceBuffer(ArrayPtr<Type, Allocator>& buffer, size_t size) noexcept {
+        RecordRelease();
+        Clear();
+        items_.swap(buffer);
+        size_ = size;
+    }
+
+    // Переносит элементы в новый буфер вместимостью new_capacity.
+    // Если аллокатор может расширить текущий буфер на месте, перенос не нужен
+    SIMPLE_VECTOR_CONSTEXPR void Reallocate(size_t new_capacity) {
+        if (items_.TryExpand(new_capacity)) {
+            return;
+        }
+        ArrayPtr<Type, Allocator> temp(new_capacity, items_.GetAllocator());
+        simple_vector_detail::RelocateRange(temp.GetAllocator(), begin(), end(), temp.Get());
+        RecordReallocation();
+        items_.swap(temp);
+    }
+
+    // Учитывает перенос size_ элементов из текущего буфера в новый (SIMPLE_VECTOR_STATS, см. stats.h).
+    // Первое выделение переносом не считается.
+    // Элементы копируются, только если перемещение может бросить, а копирование доступно
+    SIMPLE_VECTOR_CONSTEXPR void RecordReallocation() const noexcept {
+        simple_vector_detail::RecordStats<Type>([this](auto& stats) {
+            if (GetCapacity() == 0) {
+                return;
+            }
+            constexpr bool moved = kIsTriviallyRelocatable<Type> || std::is_nothrow_move_constructible_v<Type>
+                                   || !std::is_copy_constructible_v<Type>;
+            stats.RecordReallocation(size_, moved, (GetCapacity() - size_) * sizeof(Type));
+        });
+    }
+
+    // Учитывает неиспользованную вместимость освобождаемого буфера
+    SIMPLE_VECTOR_CONSTEXPR void RecordRelease() const noexcept {
+        simple_vector_detail::RecordStats<Type>([this](auto& stats) {
+            stats.RecordWaste((GetCapacity() - size_) * sizeof(Type));
+        });
+    }
+
+    ArrayPtr<Type, Allocator> items_;
     size_t size_ = 0;
-    size_t capacity_ = 0;
 };
- 
-template <typename Type> //основной
-inline bool operator==(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
-}
 
+// Вектор, память которого выделяется из std::pmr::memory_resource
+template <typename Type>
+using PmrSimpleVector = SimpleVector<Type, std::pmr::polymorphic_allocator<Type>>;
+
+// Вектор в линейной арене: ArenaSimpleVector<int> v(arena);
+// Пока вектор владеет последним выделением арены, рост происходит на месте
 template <typename Type>
-inline bool operator!=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+using ArenaSimpleVector = SimpleVector<Type, ArenaAllocator<Type>>;
+
+// Вектор, начало буфера которого выровнено по Alignment байт: AlignedSimpleVector<float, 64> v;
+template <typename Type, size_t Alignment = 64>
+using AlignedSimpleVector = SimpleVector<Type, AlignedAllocator<Type, Alignment>>;
+
+template <typename Type, typename Allocator, typename GrowthPolicy> //основной
+SIMPLE_VECTOR_CONSTEXPR inline bool operator==(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return simple_vector_simd::Equal(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator!=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(lhs == rhs);
 }
 
-template <typename Type> //основной
-inline bool operator<(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template <typename Type, typename Allocator, typename GrowthPolicy> //основной
+SIMPLE_VECTOR_CONSTEXPR inline bool operator<(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return simple_vector_simd::Less(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
 }
 
-template <typename Type>
-inline bool operator<=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator<=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(rhs < lhs);
 }
 
-template <typename Type>
-inline bool operator>(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator>(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return rhs < lhs;
 }
 
-template <typename Type>
-inline bool operator>=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator>=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(rhs > lhs);
-}
\ No newline at end of file
+}
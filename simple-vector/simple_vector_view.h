@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simd.h"
+
+template <typename Type>
+class SimpleVectorView;
+
+namespace simple_vector_detail {
+
+// Контейнер с непрерывной памятью: begin() — указатель, приводимый к Type*, и есть GetSize()
+// (SimpleVector, SmallSimpleVector, SharedSimpleVector, MappedSimpleVector)
+template <typename Container, typename Type, typename = void>
+struct IsContiguousOf : std::false_type {};
+
+template <typename Container, typename Type>
+struct IsContiguousOf<Container, Type, std::void_t<decltype(std::declval<Container&>().GetSize())>>
+    : std::is_convertible<decltype(std::declval<Container&>().begin()), Type*> {};
+
+template <typename T>
+struct IsSimpleVectorView : std::false_type {};
+
+template <typename Type>
+struct IsSimpleVectorView<SimpleVectorView<Type>> : std::true_type {};
+
+} // namespace simple_vector_detail
+
+// Невладеющее представление непрерывного участка элементов: указатель и длина.
+// Дёшево копируется и передаётся по значению вместо копии вектора или пары итераторов.
+// Неявно создаётся из SimpleVector и других непрерывных контейнеров этого репозитория;
+// представление с const Type (ConstSimpleVectorView) получается и из константного вектора.
+// Представление не продлевает жизнь элементов: вектор не должен перевыделять память, пока оно используется
+template <typename Type>
+class SimpleVectorView {
+    using ConstView = SimpleVectorView<const std::remove_cv_t<Type>>;
+
+    template <typename Other, typename Result>
+    using IfComparable = std::enable_if_t<std::is_convertible_v<const Other&, ConstView>, Result>;
+
+    // Представления слева обслуживает их собственный оператор, иначе вызов неоднозначен
+    template <typename Other, typename Result>
+    using IfReversedComparable = std::enable_if_t<!simple_vector_detail::IsSimpleVectorView<Other>::value
+                                                  && std::is_convertible_v<const Other&, ConstView>, Result>;
+
+    static bool Equal(ConstView lhs, ConstView rhs) {
+        return simple_vector_simd::Equal(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+    }
+
+    static bool Less(ConstView lhs, ConstView rhs) {
+        return simple_vector_simd::Less(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+    }
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+    using value_type = std::remove_cv_t<Type>;
+
+    static constexpr size_t kNpos = static_cast<size_t>(-1);
+
+    SimpleVectorView() noexcept = default;
+
+    SimpleVectorView(Type* data, size_t size) noexcept
+        : data_(data), size_(size) {
+    }
+
+    // Представление диапазона итераторов вектора [first, last).
+    // Шаблон, чтобы вызов с литералом 0 вторым аргументом не был неоднозначным
+    template <typename Pointer, typename = std::enable_if_t<std::is_convertible_v<Pointer, Type*>>>
+    SimpleVectorView(Pointer first, Pointer last) noexcept
+        : data_(first), size_(static_cast<size_t>(last - first)) {
+        assert(first <= last);
+    }
+
+    // Представление всех элементов контейнера (в том числе SimpleVectorView<T> -> SimpleVectorView<const T>).
+    // Из временного контейнера можно получить только представление const Type, как у std::string_view:
+    // оно действительно до конца полного выражения, например при сравнении с временным вектором
+    template <typename Container,
+              typename Decayed = std::remove_cv_t<std::remove_reference_t<Container>>,
+              typename = std::enable_if_t<!std::is_same_v<Decayed, SimpleVectorView>
+                                          && simple_vector_detail::IsContiguousOf<std::remove_reference_t<Container>, Type>::value
+                                          && (std::is_lvalue_reference_v<Container> || std::is_const_v<Type>)>>
+    SimpleVectorView(Container&& container) noexcept
+        : data_(container.begin()), size_(container.GetSize()) {
+    }
+
+    Type* Data() const noexcept {
+        return data_;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out of range");
+        }
+        return data_[index];
+    }
+
+    Type& Front() const noexcept {
+        assert(!IsEmpty());
+        return data_[0];
+    }
+
+    Type& Back() const noexcept {
+        assert(!IsEmpty());
+        return data_[size_ - 1];
+    }
+
+    // Возвращает count элементов начиная с offset (не больше, чем осталось до конца).
+    // Выбрасывает исключение std::out_of_range, если offset > size
+    SimpleVectorView Subview(size_t offset, size_t count = kNpos) const {
+        if (offset > size_) {
+            throw std::out_of_range("out of range");
+        }
+        return SimpleVectorView(data_ + offset, std::min(count, size_ - offset));
+    }
+
+    // Первые count элементов. count не должен превышать размер
+    SimpleVectorView First(size_t count) const noexcept {
+        assert(count <= size_);
+        return SimpleVectorView(data_, count);
+    }
+
+    // Последние count элементов. count не должен превышать размер
+    SimpleVectorView Last(size_t count) const noexcept {
+        assert(count <= size_);
+        return SimpleVectorView(data_ + size_ - count, count);
+    }
+
+    // Возвращает итератор на первый элемент, равный value, либо end()
+    Iterator Find(const value_type& value) const {
+        return data_ + (simple_vector_simd::Find(cbegin(), cend(), value) - cbegin());
+    }
+
+    // Возвращает количество элементов, равных value
+    size_t Count(const value_type& value) const {
+        return simple_vector_simd::Count(cbegin(), cend(), value);
+    }
+
+    // Сообщает, есть ли элемент, равный value
+    bool Contains(const value_type& value) const {
+        return Find(value) != end();
+    }
+
+    Iterator begin() const noexcept {
+        return data_;
+    }
+
+    Iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+    // Сравнения поэлементные, как у SimpleVector. Другим операндом может быть представление
+    // с другой константностью или непрерывный контейнер, в том числе временный
+    template <typename Other>
+    friend auto operator==(const SimpleVectorView& lhs, const Other& rhs) -> IfComparable<Other, bool> {
+        return Equal(lhs, rhs);
+    }
+
+    template <typename Other>
+    friend auto operator==(const Other& lhs, const SimpleVectorView& rhs) -> IfReversedComparable<Other, bool> {
+        return Equal(lhs, rhs);
+    }
+
+    template <typename Other>
+    friend auto operator!=(const SimpleVectorView& lhs, const Other& rhs) -> IfComparable<Other, bool> {
+        return !Equal(lhs, rhs);
+    }
+
+    template <typename Other>
+    friend auto operator!=(const Other& lhs, const SimpleVectorView& rhs) -> IfReversedComparable<Other, bool> {
+        return !Equal(lhs, rhs);
+    }
+
+    template <typename Other>
+    friend auto operator<(const SimpleVectorView& lhs, const Other& rhs) -> IfComparable<Other, bool> {
+        return Less(lhs, rhs);
+    }
+
+    template <typename Other>
+    friend auto operator<(const Other& lhs, const SimpleVectorView& rhs) -> IfReversedComparable<Other, bool> {
+        return Less(lhs, rhs);
+    }
+
+    template <typename Other>
+    friend auto operator<=(const SimpleVectorView& lhs, const Other& rhs) -> IfComparable<Other, bool> {
+        return !Less(rhs, lhs);
+    }
+
+    template <typename Other>
+    friend auto operator<=(const Other& lhs, const SimpleVectorView& rhs) -> IfReversedComparable<Other, bool> {
+        return !Less(rhs, lhs);
+    }
+
+    template <typename Other>
+    friend auto operator>(const SimpleVectorView& lhs, const Other& rhs) -> IfComparable<Other, bool> {
+        return Less(rhs, lhs);
+    }
+
+    template <typename Other>
+    friend auto operator>(const Other& lhs, const SimpleVectorView& rhs) -> IfReversedComparable<Other, bool> {
+        return Less(rhs, lhs);
+    }
+
+    template <typename Other>
+    friend auto operator>=(const SimpleVectorView& lhs, const Other& rhs) -> IfComparable<Other, bool> {
+        return !Less(lhs, rhs);
+    }
+
+    template <typename Other>
+    friend auto operator>=(const Other& lhs, const SimpleVectorView& rhs) -> IfReversedComparable<Other, bool> {
+        return !Less(lhs, rhs);
+    }
+
+private:
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename Type>
+using ConstSimpleVectorView = SimpleVectorView<const Type>;
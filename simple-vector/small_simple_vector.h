@@ -0,0 +1,395 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "simd.h"
+#include "simple_vector.h"
+#include "uninitialized.h"
+
+// Вектор с оптимизацией малого размера: до N элементов хранятся внутри объекта,
+// при превышении — в куче через ArrayPtr. Интерфейс совпадает с SimpleVector,
+// так что его можно подменить заменой псевдонима типа.
+template <typename Type, size_t N, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class SmallSimpleVector {
+    static_assert(N > 0, "Inline capacity must be positive");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+    using allocator_type = Allocator;
+
+    // Количество элементов, хранимых без обращения к куче
+    static constexpr size_t kInlineCapacity = N;
+
+    SmallSimpleVector() noexcept(noexcept(Allocator())) = default;
+
+    explicit SmallSimpleVector(const Allocator& alloc) noexcept : heap_(alloc) {}
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SmallSimpleVector(size_t size, const Allocator& alloc = Allocator()) : heap_(alloc) {
+        Reserve(size);
+        simple_vector_detail::UninitializedValueConstruct(heap_.GetAllocator(), begin(), size);
+        size_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SmallSimpleVector(size_t size, const Type& value, const Allocator& alloc = Allocator()) : heap_(alloc) {
+        Reserve(size);
+        simple_vector_detail::UninitializedFill(heap_.GetAllocator(), begin(), size, value);
+        size_ = size;
+    }
+
+    // Конструктор, который будет сразу резервировать нужное количество памяти
+    SmallSimpleVector(ReserveProxyObj obj, const Allocator& alloc = Allocator()) : heap_(alloc) {
+        Reserve(obj.capacity_to_reserve_);
+    }
+
+    // Создаёт вектор из std::initializer_list
+    SmallSimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator()) : heap_(alloc) {
+        Reserve(init.size());
+        simple_vector_detail::UninitializedCopy(heap_.GetAllocator(), init.begin(), init.end(), begin());
+        size_ = init.size();
+    }
+
+    SmallSimpleVector(const SmallSimpleVector& other)
+        : heap_(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.heap_.GetAllocator())) {
+        Reserve(other.size_);
+        simple_vector_detail::UninitializedCopy(heap_.GetAllocator(), other.begin(), other.end(), begin());
+        size_ = other.size_;
+    }
+
+    // Конструктор перемещения.
+    // Буфер из кучи забирается целиком, элементы из внутреннего буфера перемещаются по одному
+    SmallSimpleVector(SmallSimpleVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) : heap_(other.heap_.GetAllocator()) {
+        StealFrom(other);
+    }
+
+    ~SmallSimpleVector() {
+        simple_vector_detail::DestroyRange(heap_.GetAllocator(), begin(), end());
+    }
+
+    SmallSimpleVector& operator=(const SmallSimpleVector& rhs) {
+        if (this != &rhs) {
+            SmallSimpleVector temp(rhs);
+            *this = std::move(temp);
+        }
+        return *this;
+    }
+
+    SmallSimpleVector& operator=(SmallSimpleVector&& rhs) {
+        if (this != &rhs) {
+            Clear();
+            heap_ = ArrayPtr<Type, Allocator>(heap_.GetAllocator());
+            StealFrom(rhs);
+        }
+        return *this;
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+    // Задаёт ёмкость вектора. Ёмкость не бывает меньше N
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            Reallocate(new_capacity);
+        }
+    }
+
+    // Уменьшает вместимость до текущего размера.
+    // Если элементы помещаются во внутренний буфер, буфер в куче освобождается
+    void ShrinkToFit() {
+        if (IsInline() || size_ == GetCapacity()) {
+            return;
+        }
+        if (size_ <= N) {
+            ArrayPtr<Type, Allocator> heap(std::move(heap_));
+            heap_ = ArrayPtr<Type, Allocator>(heap.GetAllocator());
+            try {
+                simple_vector_detail::RelocateRange(heap_.GetAllocator(), heap.Get(), heap.Get() + size_, InlineData());
+            } catch (...) {
+                heap_ = std::move(heap);
+                throw;
+            }
+            return;
+        }
+        ArrayPtr<Type, Allocator> temp(size_, heap_.GetAllocator());
+        simple_vector_detail::RelocateRange(temp.GetAllocator(), begin(), end(), temp.Get());
+        heap_.swap(temp);
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Вставляет значение value в позицию pos. Возвращает итератор на вставленное значение
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент в конце вектора из аргументов args. Возвращает ссылку на него
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ < GetCapacity() || heap_.TryExpand(NextCapacity(size_ + 1))) {
+            simple_vector_detail::ConstructAt(heap_.GetAllocator(), end(), std::forward<Args>(args)...);
+            ++size_;
+            return *(end() - 1);
+        }
+        // новый элемент создаётся до переноса старых: аргументы могут ссылаться на элемент вектора
+        ArrayPtr<Type, Allocator> temp(NextCapacity(size_ + 1), heap_.GetAllocator());
+        auto& alloc = temp.GetAllocator();
+        simple_vector_detail::ConstructAt(alloc, temp.Get() + size_, std::forward<Args>(args)...);
+        try {
+            simple_vector_detail::RelocateRange(alloc, begin(), end(), temp.Get());
+        } catch (...) {
+            simple_vector_detail::DestroyAt(alloc, temp.Get() + size_);
+            throw;
+        }
+        heap_.swap(temp);
+        ++size_;
+        return *(end() - 1);
+    }
+
+    // Создаёт элемент из аргументов args в позиции pos. Возвращает итератор на него
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        const size_t index = static_cast<size_t>(pos - begin());
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return begin() + index;
+        }
+        // аргументы могут ссылаться на сдвигаемый элемент, поэтому сначала создаём значение
+        Type temp_value(std::forward<Args>(args)...);
+        if (size_ == GetCapacity()) {
+            Reallocate(NextCapacity(size_ + 1));
+        }
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            Iterator hole = begin() + index;
+            simple_vector_detail::RelocateOverlapping(hole, end(), hole + 1);
+            try {
+                simple_vector_detail::ConstructAt(heap_.GetAllocator(), hole, std::move(temp_value));
+            } catch (...) {
+                simple_vector_detail::RelocateOverlapping(hole + 1, end() + 1, hole);
+                throw;
+            }
+            ++size_;
+        } else {
+            simple_vector_detail::ConstructAt(heap_.GetAllocator(), end(), std::move(begin()[size_ - 1]));
+            ++size_;
+            std::move_backward(begin() + index, end() - 2, end() - 1);
+            begin()[index] = std::move(temp_value);
+        }
+        return begin() + index;
+    }
+
+    void PopBack() noexcept {
+        if (!IsEmpty()) {
+            --size_;
+            simple_vector_detail::DestroyAt(heap_.GetAllocator(), end());
+        }
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        assert(pos >= begin() && pos < end());
+        auto index = pos - begin();
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            Iterator erased = begin() + index;
+            simple_vector_detail::DestroyAt(heap_.GetAllocator(), erased);
+            simple_vector_detail::RelocateOverlapping(erased + 1, end(), erased);
+            --size_;
+        } else {
+            std::move(begin() + index + 1, end(), begin() + index);
+            PopBack();
+        }
+        return begin() + index;
+    }
+
+    void swap(SmallSimpleVector& other) {
+        if (IsInline() || other.IsInline()) {
+            SmallSimpleVector temp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(temp);
+        } else {
+            heap_.swap(other.heap_);
+            std::swap(size_, other.size_);
+        }
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return IsInline() ? N : heap_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return !GetSize();
+    }
+
+    // Сообщает, хранятся ли элементы во внутреннем буфере
+    bool IsInline() const noexcept {
+        return !heap_;
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return begin()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return begin()[index];
+    }
+
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("out of range");
+        }
+        return begin()[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out of range");
+        }
+        return begin()[index];
+    }
+
+    void Clear() noexcept {
+        simple_vector_detail::DestroyRange(heap_.GetAllocator(), begin(), end());
+        size_ = 0;
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            simple_vector_detail::DestroyRange(heap_.GetAllocator(), begin() + new_size, end());
+            size_ = new_size;
+            return;
+        }
+        if (new_size > GetCapacity()) {
+            Reallocate(NextCapacity(new_size));
+        }
+        simple_vector_detail::UninitializedValueConstruct(heap_.GetAllocator(), end(), new_size - size_);
+        size_ = new_size;
+    }
+
+    Iterator begin() noexcept {
+        return IsInline() ? InlineData() : heap_.Get();
+    }
+
+    Iterator end() noexcept {
+        return begin() + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return IsInline() ? InlineData() : heap_.Get();
+    }
+
+    ConstIterator end() const noexcept {
+        return begin() + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    size_t NextCapacity(size_t required) const {
+        const size_t max_size = std::allocator_traits<Allocator>::max_size(heap_.GetAllocator());
+        if (required > max_size) {
+            throw std::length_error("SmallSimpleVector is too long");
+        }
+        const size_t next = GrowthPolicy::NextCapacity(GetCapacity(), required, sizeof(Type));
+        return std::clamp(next, required, max_size);
+    }
+
+    Type* InlineData() noexcept {
+        return reinterpret_cast<Type*>(inline_);
+    }
+
+    const Type* InlineData() const noexcept {
+        return reinterpret_cast<const Type*>(inline_);
+    }
+
+    // Забирает содержимое other; сам вектор должен быть пуст и без буфера в куче.
+    // Буфер из кучи забирается целиком, если аллокатор это позволяет,
+    // иначе элементы перемещаются по одному
+    void StealFrom(SmallSimpleVector& other) {
+        using AllocTraits = std::allocator_traits<Allocator>;
+        if (!other.IsInline() && (AllocTraits::propagate_on_container_move_assignment::value
+                                  || heap_.GetAllocator() == other.heap_.GetAllocator())) {
+            heap_ = std::move(other.heap_);
+            size_ = std::exchange(other.size_, 0);
+            return;
+        }
+        Reserve(other.size_);
+        simple_vector_detail::RelocateRange(heap_.GetAllocator(), other.begin(), other.end(), begin());
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    // Переносит элементы в буфер в куче вместимостью new_capacity
+    void Reallocate(size_t new_capacity) {
+        if (heap_.TryExpand(new_capacity)) {
+            return;
+        }
+        ArrayPtr<Type, Allocator> temp(new_capacity, heap_.GetAllocator());
+        simple_vector_detail::RelocateRange(temp.GetAllocator(), begin(), end(), temp.Get());
+        heap_.swap(temp);
+    }
+
+    ArrayPtr<Type, Allocator> heap_;
+    size_t size_ = 0;
+    alignas(Type) unsigned char inline_[N * sizeof(Type)];
+};
+
+template <typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator==(const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& rhs) {
+    return simple_vector_simd::Equal(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+}
+
+template <typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator!=(const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator<(const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& rhs) {
+    return simple_vector_simd::Less(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+}
+
+template <typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator<=(const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator>(const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator>=(const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& lhs, const SmallSimpleVector<Type, N, Allocator, GrowthPolicy>& rhs) {
+    return !(rhs > lhs);
+}
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "simple_vector.h"
+#include "simple_vector_view.h"
+
+// Структура массивов: строка из полей Ts... хранится не подряд, а по одному непрерывному
+// столбцу SimpleVector на поле. Проход по одному-двум полям читает из памяти только их.
+// Все столбцы всегда одной длины и растут вместе (вместимость одинакова).
+// Строка доступна как прокси-ссылка std::tuple<Ts&...>: auto [x, y] = soa[i];
+template <typename... Ts>
+class SoASimpleVector {
+    static_assert(sizeof...(Ts) > 0, "SoASimpleVector needs at least one field");
+
+    using Columns = std::tuple<SimpleVector<Ts>...>;
+    using Indices = std::index_sequence_for<Ts...>;
+
+    template <typename Owner, typename Ref>
+    class BasicIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::tuple<Ts...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = Ref;
+        using pointer = void;
+
+        BasicIterator() = default;
+
+        template <typename OtherOwner, typename OtherRef,
+                  typename = std::enable_if_t<std::is_convertible_v<OtherOwner*, Owner*>>>
+        BasicIterator(const BasicIterator<OtherOwner, OtherRef>& other) noexcept
+            : owner_(other.owner_), index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator copy = *this;
+            --index_;
+            return copy;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += static_cast<size_t>(offset);
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= static_cast<size_t>(offset);
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_ - rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+    private:
+        template <typename, typename>
+        friend class BasicIterator;
+        friend class SoASimpleVector;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner), index_(index) {
+        }
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using Row = std::tuple<Ts...>;
+    using Reference = std::tuple<Ts&...>;
+    using ConstReference = std::tuple<const Ts&...>;
+    using Iterator = BasicIterator<SoASimpleVector, Reference>;
+    using ConstIterator = BasicIterator<const SoASimpleVector, ConstReference>;
+
+    template <size_t I>
+    using ColumnType = std::tuple_element_t<I, Row>;
+
+    SoASimpleVector() = default;
+
+    // Создаёт size строк, поля которых инициализированы значением по умолчанию
+    explicit SoASimpleVector(size_t size)
+        : columns_(SimpleVector<Ts>(size)...) {
+    }
+
+    SoASimpleVector(std::initializer_list<Row> rows) {
+        Reserve(rows.size());
+        for (const Row& row : rows) {
+            PushBack(row);
+        }
+    }
+
+    size_t GetSize() const noexcept {
+        return std::get<0>(columns_).GetSize();
+    }
+
+    size_t GetCapacity() const noexcept {
+        return std::get<0>(columns_).GetCapacity();
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Возвращает прокси-ссылку на строку index
+    Reference operator[](size_t index) noexcept {
+        assert(index < GetSize());
+        return RowAt(*this, index, Indices{});
+    }
+
+    ConstReference operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return RowAt(*this, index, Indices{});
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Reference At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("out of range");
+        }
+        return (*this)[index];
+    }
+
+    ConstReference At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("out of range");
+        }
+        return (*this)[index];
+    }
+
+    // Возвращает непрерывный столбец поля I
+    template <size_t I>
+    SimpleVectorView<ColumnType<I>> Column() noexcept {
+        return std::get<I>(columns_);
+    }
+
+    template <size_t I>
+    ConstSimpleVectorView<ColumnType<I>> Column() const noexcept {
+        return std::get<I>(columns_);
+    }
+
+    // Резервирует место под new_capacity строк во всех столбцах
+    void Reserve(size_t new_capacity) {
+        std::apply([new_capacity](auto&... columns) {
+            (columns.Reserve(new_capacity), ...);
+        }, columns_);
+    }
+
+    // Добавляет строку. Если создание поля бросило исключение, уже добавленные поля
+    // этой строки удаляются: столбцы остаются одной длины
+    void PushBack(const Row& row) {
+        AppendRow(row, Indices{});
+    }
+
+    void PushBack(Row&& row) {
+        AppendRow(std::move(row), Indices{});
+    }
+
+    // Добавляет строку, создавая каждое поле из своего аргумента
+    template <typename... Args, typename = std::enable_if_t<sizeof...(Args) == sizeof...(Ts)>>
+    Reference EmplaceBack(Args&&... args) {
+        AppendRow(std::forward_as_tuple(std::forward<Args>(args)...), Indices{});
+        return (*this)[GetSize() - 1];
+    }
+
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        std::apply([](auto&... columns) {
+            (columns.PopBack(), ...);
+        }, columns_);
+    }
+
+    // Удаляет строку pos и возвращает итератор на следующую
+    Iterator Erase(ConstIterator pos) {
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет строки [first, last)
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t first_index = first.GetIndex();
+        const size_t last_index = last.GetIndex();
+        assert(first_index <= last_index && last_index <= GetSize());
+        std::apply([first_index, last_index](auto&... columns) {
+            (columns.Erase(columns.begin() + first_index, columns.begin() + last_index), ...);
+        }, columns_);
+        return Iterator(this, first_index);
+    }
+
+    // Изменяет количество строк; новые поля инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        Reserve(new_size);
+        std::apply([new_size](auto&... columns) {
+            (columns.Resize(new_size), ...);
+        }, columns_);
+    }
+
+    void Clear() noexcept {
+        std::apply([](auto&... columns) {
+            (columns.Clear(), ...);
+        }, columns_);
+    }
+
+    void swap(SoASimpleVector& other) noexcept {
+        columns_.swap(other.columns_);
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, GetSize());
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, GetSize());
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    template <typename Self, size_t... Is>
+    static auto RowAt(Self& self, size_t index, std::index_sequence<Is...>) noexcept {
+        using Result = std::conditional_t<std::is_const_v<Self>, ConstReference, Reference>;
+        return Result(std::get<Is>(self.columns_)[index]...);
+    }
+
+    // При нехватке места все столбцы растут до одной вместимости заранее:
+    // затем добавление поля может бросить только из конструктора элемента
+    void EnsureRoom() {
+        const size_t size = GetSize();
+        if (size == GetCapacity()) {
+            Reserve(DoublingGrowth::NextCapacity(GetCapacity(), size + 1, sizeof(Row)));
+        }
+    }
+
+    template <typename Tuple, size_t... Is>
+    void AppendRow(Tuple&& row, std::index_sequence<Is...>) {
+        EnsureRoom();
+        size_t appended = 0;
+        try {
+            ((std::get<Is>(columns_).EmplaceBack(std::get<Is>(std::forward<Tuple>(row))), ++appended), ...);
+        } catch (...) {
+            RollBack(appended, Indices{});
+            throw;
+        }
+    }
+
+    // Удаляет последний элемент у первых count столбцов
+    template <size_t... Is>
+    void RollBack(size_t count, std::index_sequence<Is...>) noexcept {
+        ((Is < count ? std::get<Is>(columns_).PopBack() : void()), ...);
+    }
+
+    Columns columns_;
+};
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simd.h"
+#include "uninitialized.h"
+
+namespace simple_vector_detail {
+
+// Наименьший беззнаковый тип, вмещающий числа от 0 до N
+template <size_t N>
+using StaticSizeType = std::conditional_t<N <= std::numeric_limits<uint8_t>::max(), uint8_t,
+                       std::conditional_t<N <= std::numeric_limits<uint16_t>::max(), uint16_t,
+                       std::conditional_t<N <= std::numeric_limits<uint32_t>::max(), uint32_t, size_t>>>;
+
+// Элементы создаются и разрушаются через std::allocator_traits, как в SimpleVector.
+// У std::allocator нет состояния, поэтому хватает одного объекта на тип
+template <typename Type>
+std::allocator<Type>& StaticAllocator() noexcept {
+    static std::allocator<Type> alloc;
+    return alloc;
+}
+
+// Память под N элементов и их количество. Для тривиально копируемых Type специальные
+// функции тривиальны (копируются байты, в том числе неиспользуемого хвоста),
+// иначе копируются, перемещаются и разрушаются только созданные элементы
+template <typename Type, size_t N, bool = std::is_trivially_copyable_v<Type>>
+class StaticStorage {
+protected:
+    Type* Data() noexcept {
+        return reinterpret_cast<Type*>(bytes_);
+    }
+
+    const Type* Data() const noexcept {
+        return reinterpret_cast<const Type*>(bytes_);
+    }
+
+    alignas(Type) unsigned char bytes_[(N == 0 ? 1 : N) * sizeof(Type)];
+    StaticSizeType<N> size_ = 0;
+};
+
+template <typename Type, size_t N>
+class StaticStorage<Type, N, false> {
+protected:
+    StaticStorage() noexcept = default;
+
+    StaticStorage(const StaticStorage& other) {
+        UninitializedCopy(StaticAllocator<Type>(), other.Data(), other.Data() + other.size_, Data());
+        size_ = other.size_;
+    }
+
+    StaticStorage(StaticStorage&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        UninitializedMove(StaticAllocator<Type>(), other.Data(), other.Data() + other.size_, Data());
+        size_ = other.size_;
+    }
+
+    ~StaticStorage() {
+        DestroyRange(StaticAllocator<Type>(), Data(), Data() + size_);
+    }
+
+    // Переприсваивает общую часть, недостающие элементы создаёт, лишние разрушает
+    StaticStorage& operator=(const StaticStorage& rhs) {
+        if (this != &rhs) {
+            AssignFrom(rhs.Data(), rhs.size_);
+        }
+        return *this;
+    }
+
+    StaticStorage& operator=(StaticStorage&& rhs) noexcept(std::is_nothrow_move_assignable_v<Type>
+                                                           && std::is_nothrow_move_constructible_v<Type>) {
+        if (this != &rhs) {
+            AssignFrom(std::make_move_iterator(rhs.Data()), rhs.size_);
+        }
+        return *this;
+    }
+
+    Type* Data() noexcept {
+        return reinterpret_cast<Type*>(bytes_);
+    }
+
+    const Type* Data() const noexcept {
+        return reinterpret_cast<const Type*>(bytes_);
+    }
+
+    alignas(Type) unsigned char bytes_[(N == 0 ? 1 : N) * sizeof(Type)];
+    StaticSizeType<N> size_ = 0;
+
+private:
+    template <typename It>
+    void AssignFrom(It first, size_t count) {
+        const size_t common = std::min<size_t>(count, size_);
+        const It common_end = first + static_cast<std::ptrdiff_t>(common);
+        std::copy(first, common_end, Data());
+        if (count > size_) {
+            UninitializedCopy(StaticAllocator<Type>(), common_end, first + static_cast<std::ptrdiff_t>(count), Data() + size_);
+        } else {
+            DestroyRange(StaticAllocator<Type>(), Data() + count, Data() + size_);
+        }
+        size_ = static_cast<StaticSizeType<N>>(count);
+    }
+};
+
+} // namespace simple_vector_detail
+
+// Вектор фиксированной вместимости N с элементами прямо в объекте: память из кучи не выделяется
+// никогда, поэтому время операций предсказуемо. Интерфейс как у SimpleVector, но рост за N —
+// ошибка программы: PushBack, Insert, Resize и конструкторы проверяют это через assert,
+// а TryPushBack и TryEmplaceBack сообщают о нехватке места результатом.
+// Для тривиально копируемых Type вектор тоже тривиально копируем (его можно копировать memcpy
+// внутри сообщений), а поле размера занимает наименьший подходящий тип: uint8_t при N <= 255
+template <typename Type, size_t N>
+class StaticSimpleVector : private simple_vector_detail::StaticStorage<Type, N> {
+    using Storage = simple_vector_detail::StaticStorage<Type, N>;
+    using SizeType = simple_vector_detail::StaticSizeType<N>;
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    StaticSimpleVector() noexcept = default;
+
+    // Создаёт size элементов, инициализированных значением по умолчанию
+    explicit StaticSimpleVector(size_t size) {
+        assert(size <= N);
+        simple_vector_detail::UninitializedValueConstruct(Alloc(), data(), size);
+        size_ = static_cast<SizeType>(size);
+    }
+
+    // Создаёт size элементов, инициализированных значением value
+    StaticSimpleVector(size_t size, const Type& value) {
+        assert(size <= N);
+        simple_vector_detail::UninitializedFill(Alloc(), data(), size, value);
+        size_ = static_cast<SizeType>(size);
+    }
+
+    StaticSimpleVector(std::initializer_list<Type> init) {
+        assert(init.size() <= N);
+        simple_vector_detail::UninitializedCopy(Alloc(), init.begin(), init.end(), data());
+        size_ = static_cast<SizeType>(init.size());
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    static constexpr size_t GetCapacity() noexcept {
+        return N;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    bool IsFull() const noexcept {
+        return size_ == N;
+    }
+
+    // Вместимость фиксирована: только проверяет, что new_capacity <= N
+    void Reserve([[maybe_unused]] size_t new_capacity) noexcept {
+        assert(new_capacity <= N);
+    }
+
+    // Добавляет элемент в конец вектора. Вектор не должен быть заполнен
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент в конце вектора. Вектор не должен быть заполнен
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        assert(!IsFull());
+        simple_vector_detail::ConstructAt(Alloc(), end(), std::forward<Args>(args)...);
+        ++size_;
+        return *(end() - 1);
+    }
+
+    // Добавляет элемент, если есть место. Возвращает false, если вектор заполнен
+    [[nodiscard]] bool TryPushBack(const Type& item) {
+        return TryEmplaceBack(item) != nullptr;
+    }
+
+    [[nodiscard]] bool TryPushBack(Type&& item) {
+        return TryEmplaceBack(std::move(item)) != nullptr;
+    }
+
+    // Создаёт элемент в конце, если есть место. Возвращает указатель на него либо nullptr
+    template <typename... Args>
+    [[nodiscard]] Type* TryEmplaceBack(Args&&... args) {
+        if (IsFull()) {
+            return nullptr;
+        }
+        return &EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    // Вставляет значение value в позицию pos. Возвращает итератор на вставленное значение.
+    // Вектор не должен быть заполнен
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент из аргументов args в позиции pos. Вектор не должен быть заполнен
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        assert(!IsFull());
+        const size_t index = static_cast<size_t>(pos - cbegin());
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return begin() + index;
+        }
+        // аргументы могут ссылаться на сдвигаемый элемент, поэтому сначала создаём значение
+        Type temp_value(std::forward<Args>(args)...);
+        Iterator hole = begin() + index;
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            simple_vector_detail::RelocateOverlapping(hole, end(), hole + 1);
+            try {
+                simple_vector_detail::ConstructAt(Alloc(), hole, std::move(temp_value));
+            } catch (...) {
+                simple_vector_detail::RelocateOverlapping(hole + 1, end() + 1, hole);
+                throw;
+            }
+            ++size_;
+        } else {
+            simple_vector_detail::ConstructAt(Alloc(), end(), std::move(*(end() - 1)));
+            ++size_;
+            std::move_backward(hole, end() - 2, end() - 1);
+            *hole = std::move(temp_value);
+        }
+        return hole;
+    }
+
+    // Удаляет последний элемент вектора
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        simple_vector_detail::DestroyAt(Alloc(), end());
+    }
+
+    // Удаляет элемент в позиции pos и возвращает итератор на следующий
+    Iterator Erase(ConstIterator pos) {
+        assert(pos >= begin() && pos < end());
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last). Хвост сдвигается один раз
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(begin() <= first && first <= last && last <= end());
+        const size_t index = static_cast<size_t>(first - cbegin());
+        const size_t count = static_cast<size_t>(last - first);
+        Iterator erased = begin() + index;
+        if (count == 0) {
+            return erased;
+        }
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            simple_vector_detail::DestroyRange(Alloc(), erased, erased + count);
+            simple_vector_detail::RelocateOverlapping(erased + count, end(), erased);
+        } else {
+            std::move(erased + count, end(), erased);
+            simple_vector_detail::DestroyRange(Alloc(), end() - count, end());
+        }
+        size_ = static_cast<SizeType>(size_ - count);
+        return erased;
+    }
+
+    // Изменяет размер; новые элементы получают значение по умолчанию. new_size не больше N
+    void Resize(size_t new_size) {
+        assert(new_size <= N);
+        if (new_size <= size_) {
+            simple_vector_detail::DestroyRange(Alloc(), begin() + new_size, end());
+        } else {
+            simple_vector_detail::UninitializedValueConstruct(Alloc(), end(), new_size - size_);
+        }
+        size_ = static_cast<SizeType>(new_size);
+    }
+
+    void Clear() noexcept {
+        simple_vector_detail::DestroyRange(Alloc(), begin(), end());
+        size_ = 0;
+    }
+
+    // Обменивает содержимое поэлементно: памяти в куче, которую можно было бы обменять, нет
+    void swap(StaticSimpleVector& other) noexcept(std::is_nothrow_swappable_v<Type>
+                                                  && std::is_nothrow_move_constructible_v<Type>) {
+        StaticSimpleVector& shorter = size_ <= other.size_ ? *this : other;
+        StaticSimpleVector& longer = size_ <= other.size_ ? other : *this;
+        const size_t common = shorter.size_;
+        std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+        simple_vector_detail::UninitializedMove(Alloc(), longer.begin() + common, longer.end(), shorter.end());
+        simple_vector_detail::DestroyRange(Alloc(), longer.begin() + common, longer.end());
+        std::swap(shorter.size_, longer.size_);
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("out of range");
+        }
+        return data()[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("out of range");
+        }
+        return data()[index];
+    }
+
+    // Возвращает итератор на первый элемент, равный value, либо end()
+    Iterator Find(const Type& value) {
+        return begin() + (simple_vector_simd::Find(cbegin(), cend(), value) - cbegin());
+    }
+
+    ConstIterator Find(const Type& value) const {
+        return simple_vector_simd::Find(cbegin(), cend(), value);
+    }
+
+    // Возвращает количество элементов, равных value
+    size_t Count(const Type& value) const {
+        return simple_vector_simd::Count(cbegin(), cend(), value);
+    }
+
+    bool Contains(const Type& value) const {
+        return Find(value) != cend();
+    }
+
+    Iterator begin() noexcept {
+        return data();
+    }
+
+    Iterator end() noexcept {
+        return data() + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return data();
+    }
+
+    ConstIterator end() const noexcept {
+        return data() + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return data();
+    }
+
+    ConstIterator cend() const noexcept {
+        return data() + size_;
+    }
+
+private:
+    using Storage::size_;
+
+    Type* data() noexcept {
+        return Storage::Data();
+    }
+
+    const Type* data() const noexcept {
+        return Storage::Data();
+    }
+
+    static std::allocator<Type>& Alloc() noexcept {
+        return simple_vector_detail::StaticAllocator<Type>();
+    }
+};
+
+template <typename Type, size_t N>
+inline bool operator==(const StaticSimpleVector<Type, N>& lhs, const StaticSimpleVector<Type, N>& rhs) {
+    return simple_vector_simd::Equal(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+}
+
+template <typename Type, size_t N>
+inline bool operator!=(const StaticSimpleVector<Type, N>& lhs, const StaticSimpleVector<Type, N>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t N>
+inline bool operator<(const StaticSimpleVector<Type, N>& lhs, const StaticSimpleVector<Type, N>& rhs) {
+    return simple_vector_simd::Less(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+}
+
+template <typename Type, size_t N>
+inline bool operator<=(const StaticSimpleVector<Type, N>& lhs, const StaticSimpleVector<Type, N>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t N>
+inline bool operator>(const StaticSimpleVector<Type, N>& lhs, const StaticSimpleVector<Type, N>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t N>
+inline bool operator>=(const StaticSimpleVector<Type, N>& lhs, const StaticSimpleVector<Type, N>& rhs) {
+    return !(lhs < rhs);
+}
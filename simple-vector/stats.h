@@ -0,0 +1,231 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string_view>
+#include <typeinfo>
+
+#include "config.h"
+
+// Статистика выделений памяти и переносов элементов SimpleVector.
+// Включается макросом SIMPLE_VECTOR_STATS (-DSIMPLE_VECTOR_STATS для всей программы);
+// без него счётчиков нет, а вызовы учёта пусты и исчезают при компиляции.
+// Учёт ведётся по всем векторам сразу и отдельно по каждому типу элементов.
+// Счётчики атомарны (relaxed): снимок, сделанный во время работы других потоков, приблизителен.
+// Неиспользованная вместимость учитывается накопительно, в момент освобождения или замены буфера;
+// текущий запас конкретного вектора — GetCapacity() − GetSize()
+
+struct SimpleVectorStatsSnapshot {
+    uint64_t allocations = 0;           // выделено буферов
+    uint64_t deallocations = 0;         // освобождено буферов
+    uint64_t bytes_allocated = 0;       // всего выделено байт, включая расширение на месте
+    uint64_t reallocations = 0;         // переносов элементов в новый буфер
+    uint64_t elements_moved = 0;        // элементов перемещено при переносах
+    uint64_t elements_copied = 0;       // элементов скопировано при переносах (перемещение могло бросить)
+    uint64_t live_bytes = 0;            // байт в буферах, которыми векторы владеют сейчас
+    uint64_t peak_live_bytes = 0;       // наибольшее значение live_bytes
+    uint64_t peak_capacity_bytes = 0;   // самый большой буфер
+    uint64_t released_wasted_bytes = 0; // сумма неиспользованной вместимости (capacity − size) освобождённых и заменённых буферов
+};
+
+namespace simple_vector_detail {
+
+#if defined(SIMPLE_VECTOR_STATS)
+
+class StatsCounters {
+public:
+    void RecordAllocation(size_t bytes) noexcept {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+        UpdateMax(peak_capacity_bytes_, bytes);
+        Track(bytes);
+    }
+
+    void RecordDeallocation(size_t bytes) noexcept {
+        deallocations_.fetch_add(1, std::memory_order_relaxed);
+        Untrack(bytes);
+    }
+
+    // Буфер вырос на месте с old_bytes до new_bytes
+    void RecordExpansion(size_t old_bytes, size_t new_bytes) noexcept {
+        bytes_allocated_.fetch_add(new_bytes - old_bytes, std::memory_order_relaxed);
+        UpdateMax(peak_capacity_bytes_, new_bytes);
+        Track(new_bytes - old_bytes);
+    }
+
+    // Перенос count элементов в новый буфер; у старого осталось wasted_bytes неиспользованных байт
+    void RecordReallocation(size_t count, bool moved, size_t wasted_bytes) noexcept {
+        reallocations_.fetch_add(1, std::memory_order_relaxed);
+        (moved ? elements_moved_ : elements_copied_).fetch_add(count, std::memory_order_relaxed);
+        RecordWaste(wasted_bytes);
+    }
+
+    void RecordWaste(size_t bytes) noexcept {
+        released_wasted_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    // Учёт буфера, перешедшего во владение или из владения вектора без выделения
+    void Track(size_t bytes) noexcept {
+        const uint64_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        UpdateMax(peak_live_bytes_, live);
+    }
+
+    void Untrack(size_t bytes) noexcept {
+        live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    SimpleVectorStatsSnapshot Load() const noexcept {
+        SimpleVectorStatsSnapshot snapshot;
+        snapshot.allocations = allocations_.load(std::memory_order_relaxed);
+        snapshot.deallocations = deallocations_.load(std::memory_order_relaxed);
+        snapshot.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+        snapshot.reallocations = reallocations_.load(std::memory_order_relaxed);
+        snapshot.elements_moved = elements_moved_.load(std::memory_order_relaxed);
+        snapshot.elements_copied = elements_copied_.load(std::memory_order_relaxed);
+        snapshot.live_bytes = live_bytes_.load(std::memory_order_relaxed);
+        snapshot.peak_live_bytes = peak_live_bytes_.load(std::memory_order_relaxed);
+        snapshot.peak_capacity_bytes = peak_capacity_bytes_.load(std::memory_order_relaxed);
+        snapshot.released_wasted_bytes = released_wasted_bytes_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    // Обнуляет накопленные счётчики. Живые буферы остаются в учёте, пики начинаются с текущего значения
+    void Reset() noexcept {
+        for (auto* counter : {&allocations_, &deallocations_, &bytes_allocated_, &reallocations_,
+                              &elements_moved_, &elements_copied_, &peak_capacity_bytes_,
+                              &released_wasted_bytes_}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+        peak_live_bytes_.store(live_bytes_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+private:
+    static void UpdateMax(std::atomic<uint64_t>& target, uint64_t value) noexcept {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::atomic<uint64_t> allocations_{0};
+    std::atomic<uint64_t> deallocations_{0};
+    std::atomic<uint64_t> bytes_allocated_{0};
+    std::atomic<uint64_t> reallocations_{0};
+    std::atomic<uint64_t> elements_moved_{0};
+    std::atomic<uint64_t> elements_copied_{0};
+    std::atomic<uint64_t> live_bytes_{0};
+    std::atomic<uint64_t> peak_live_bytes_{0};
+    std::atomic<uint64_t> peak_capacity_bytes_{0};
+    std::atomic<uint64_t> released_wasted_bytes_{0};
+};
+
+inline StatsCounters global_stats;
+
+struct TypeStatsNode;
+inline std::atomic<TypeStatsNode*> type_stats_head{nullptr};
+
+// Счётчики одного типа элементов. Узлы статические (по одному на тип) и при создании
+// добавляются в список, из которого не удаляются: регистрация не выделяет память и не бросает
+struct TypeStatsNode {
+    explicit TypeStatsNode(const char* type_name) noexcept
+        : name(type_name), next(type_stats_head.load(std::memory_order_relaxed)) {
+        while (!type_stats_head.compare_exchange_weak(next, this, std::memory_order_release,
+                                                      std::memory_order_relaxed)) {
+        }
+    }
+
+    TypeStatsNode(const TypeStatsNode&) = delete;
+    TypeStatsNode& operator=(const TypeStatsNode&) = delete;
+
+    const char* name;
+    StatsCounters counters;
+    TypeStatsNode* next;
+};
+
+template <typename Type>
+StatsCounters& TypeStats() noexcept {
+    static TypeStatsNode node(typeid(Type).name());
+    return node.counters;
+}
+
+#endif
+
+// Передаёт record счётчики всех векторов и счётчики типа Type.
+// Без SIMPLE_VECTOR_STATS record не вызывается и не инстанцируется
+// Вычисления в константных выражениях не учитываются
+template <typename Type, typename Record>
+SIMPLE_VECTOR_CONSTEXPR void RecordStats([[maybe_unused]] Record&& record) noexcept {
+#if defined(SIMPLE_VECTOR_STATS)
+    if (!IsConstantEvaluated()) {
+        record(global_stats);
+        record(TypeStats<Type>());
+    }
+#endif
+}
+
+} // namespace simple_vector_detail
+
+class SimpleVectorStats {
+public:
+    // Функция экспортёра метрик: имя набора ("total" или имя типа элементов) и снимок счётчиков
+    using Exporter = std::function<void(std::string_view name, const SimpleVectorStatsSnapshot& snapshot)>;
+
+#if defined(SIMPLE_VECTOR_STATS)
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    // Возвращает счётчики по всем векторам (нули, если статистика выключена)
+    static SimpleVectorStatsSnapshot Snapshot() noexcept {
+#if defined(SIMPLE_VECTOR_STATS)
+        return simple_vector_detail::global_stats.Load();
+#else
+        return {};
+#endif
+    }
+
+    // Возвращает счётчики векторов с элементами типа Type
+    template <typename Type>
+    static SimpleVectorStatsSnapshot Snapshot() noexcept {
+#if defined(SIMPLE_VECTOR_STATS)
+        return simple_vector_detail::TypeStats<Type>().Load();
+#else
+        return {};
+#endif
+    }
+
+    // Вызывает func(name, snapshot) для каждого типа элементов, попавшего в учёт.
+    // name — typeid(Type).name(), у GCC и Clang в искажённом виде
+    template <typename Func>
+    static void ForEachType([[maybe_unused]] Func&& func) {
+#if defined(SIMPLE_VECTOR_STATS)
+        for (auto* node = simple_vector_detail::type_stats_head.load(std::memory_order_acquire); node != nullptr;
+             node = node->next) {
+            func(std::string_view(node->name), node->counters.Load());
+        }
+#endif
+    }
+
+    // Передаёт экспортёру итог под именем "total", затем счётчики каждого типа.
+    // Предназначен для периодического вызова из системы метрик
+    static void Export(const Exporter& exporter) {
+        if constexpr (kEnabled) {
+            exporter("total", Snapshot());
+            ForEachType(exporter);
+        }
+    }
+
+    // Обнуляет накопленные счётчики (например, между этапами замера)
+    static void Reset() noexcept {
+#if defined(SIMPLE_VECTOR_STATS)
+        simple_vector_detail::global_stats.Reset();
+        for (auto* node = simple_vector_detail::type_stats_head.load(std::memory_order_acquire); node != nullptr;
+             node = node->next) {
+            node->counters.Reset();
+        }
+#endif
+    }
+};
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#include "config.h"
+
+// Тип можно перенести в другую память побайтовым копированием, не вызывая
+// конструктор перемещения у нового объекта и деструктор у старого.
+// По умолчанию так переносятся тривиально копируемые типы. Для своих типов
+// (например, дескрипторов в духе unique_ptr) признак можно включить специализацией:
+// template <> struct IsTriviallyRelocatable<MyHandle> : std::true_type {};
+template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type> {};
+
+template <typename Type>
+inline constexpr bool kIsTriviallyRelocatable = IsTriviallyRelocatable<Type>::value;
+
+// Алгоритмы над неинициализированной памятью, которые создают и разрушают объекты
+// через std::allocator_traits. В отличие от std::uninitialized_* они учитывают
+// construct/destroy аллокатора (например, передачу ресурса в std::pmr-элементы).
+// При исключении уже созданные объекты разрушаются.
+namespace simple_vector_detail {
+
+template <typename Allocator, typename Type, typename... Args>
+SIMPLE_VECTOR_CONSTEXPR void ConstructAt(Allocator& alloc, Type* ptr, Args&&... args) {
+    std::allocator_traits<Allocator>::construct(alloc, ptr, std::forward<Args>(args)...);
+}
+
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void DestroyAt(Allocator& alloc, Type* ptr) noexcept {
+    std::allocator_traits<Allocator>::destroy(alloc, ptr);
+}
+
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void DestroyRange(Allocator& alloc, Type* first, Type* last) noexcept {
+    for (; first != last; ++first) {
+        DestroyAt(alloc, first);
+    }
+}
+
+template <typename It>
+using IteratorCategory = typename std::iterator_traits<It>::iterator_category;
+
+// Признаки категорий итераторов; для не-итераторов (например, целых чисел) — false
+template <typename It, typename = void>
+struct IsInputIterator : std::false_type {};
+
+template <typename It>
+struct IsInputIterator<It, std::void_t<IteratorCategory<It>>>
+    : std::is_base_of<std::input_iterator_tag, IteratorCategory<It>> {};
+
+template <typename It, typename = void>
+struct IsForwardIterator : std::false_type {};
+
+template <typename It>
+struct IsForwardIterator<It, std::void_t<IteratorCategory<It>>>
+    : std::is_base_of<std::forward_iterator_tag, IteratorCategory<It>> {};
+
+// Итератор по непрерывной памяти: указатель (а в C++20 — любой std::contiguous_iterator)
+// или std::move_iterator над таким итератором
+template <typename It>
+struct IsContiguousIterator
+#if defined(__cpp_lib_concepts) && defined(__cpp_lib_to_address)
+    : std::bool_constant<std::contiguous_iterator<It>> {
+#else
+    : std::is_pointer<It> {
+#endif
+};
+
+template <typename It>
+struct IsContiguousIterator<std::move_iterator<It>> : IsContiguousIterator<It> {};
+
+template <typename It>
+auto IteratorAddress(It it) noexcept {
+#if defined(__cpp_lib_concepts) && defined(__cpp_lib_to_address)
+    return std::to_address(it);
+#else
+    return it;
+#endif
+}
+
+template <typename It>
+auto IteratorAddress(std::move_iterator<It> it) noexcept {
+    return IteratorAddress(it.base());
+}
+
+// Диапазон [first, last) можно скопировать в Type* одним memcpy
+template <typename It, typename Type>
+inline constexpr bool kIsMemcpyCopyable = IsContiguousIterator<It>::value && std::is_trivially_copyable_v<Type>
+    && std::is_same_v<std::remove_cv_t<typename std::iterator_traits<It>::value_type>, Type>;
+
+// Создаёт копии элементов [first, last) в памяти, начиная с dest.
+// Непрерывные диапазоны тривиально копируемых типов копируются одним memcpy.
+// Возвращает указатель за последним созданным элементом
+template <typename Allocator, typename InputIt, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedCopy(Allocator& alloc, InputIt first, InputIt last, Type* dest) {
+    if constexpr (kIsMemcpyCopyable<InputIt, Type>) {
+        if (!IsConstantEvaluated()) {
+            const size_t count = static_cast<size_t>(last - first);
+            if (count > 0) {
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(IteratorAddress(first)), count * sizeof(Type));
+            }
+            return dest + count;
+        }
+    }
+    Type* current = dest;
+    try {
+        for (; first != last; ++first, ++current) {
+            ConstructAt(alloc, current, *first);
+        }
+    } catch (...) {
+        DestroyRange(alloc, dest, current);
+        throw;
+    }
+    return current;
+}
+
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedMove(Allocator& alloc, Type* first, Type* last, Type* dest) {
+    return UninitializedCopy(alloc, std::make_move_iterator(first), std::make_move_iterator(last), dest);
+}
+
+// Переносит элементы с помощью std::move_if_noexcept: если перемещение может бросить
+// исключение, а копирование доступно, элементы копируются. Так исходный диапазон
+// остаётся целым при исключении (строгая гарантия при перевыделении)
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedMoveIfNoexcept(Allocator& alloc, Type* first, Type* last, Type* dest) {
+    if constexpr (!std::is_nothrow_move_constructible_v<Type> && std::is_copy_constructible_v<Type>) {
+        return UninitializedCopy(alloc, first, last, dest);
+    } else {
+        return UninitializedMove(alloc, first, last, dest);
+    }
+}
+
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedFill(Allocator& alloc, Type* dest, size_t count, const Type& value) {
+    Type* current = dest;
+    try {
+        for (; count > 0; --count, ++current) {
+            ConstructAt(alloc, current, value);
+        }
+    } catch (...) {
+        DestroyRange(alloc, dest, current);
+        throw;
+    }
+    return current;
+}
+
+// Создаёт count элементов, инициализированных значением по умолчанию Type{}
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedValueConstruct(Allocator& alloc, Type* dest, size_t count) {
+    Type* current = dest;
+    try {
+        for (; count > 0; --count, ++current) {
+            ConstructAt(alloc, current);
+        }
+    } catch (...) {
+        DestroyRange(alloc, dest, current);
+        throw;
+    }
+    return current;
+}
+
+// Создаёт count элементов инициализацией по умолчанию (new Type, а не new Type()):
+// значения тривиальных типов не обнуляются, и память не трогается вовсе.
+// Нетривиальные типы создаются конструктором по умолчанию через аллокатор
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedDefaultConstruct(Allocator& alloc, Type* dest, size_t count) {
+    // в константном выражении память нельзя оставить неинициализированной — она обнуляется
+    if constexpr (std::is_trivially_default_constructible_v<Type>) {
+        if (!IsConstantEvaluated()) {
+            for (size_t i = 0; i < count; ++i) {
+                ::new (static_cast<void*>(dest + i)) Type;
+            }
+            return dest + count;
+        }
+    }
+    return UninitializedValueConstruct(alloc, dest, count);
+}
+
+// Переносит элементы [first, last) в неинициализированную память dest и разрушает исходные.
+// Тривиально перемещаемые типы переносятся одним memcpy, остальные —
+// через std::move_if_noexcept. При исключении исходные элементы остаются нетронутыми
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* RelocateRange(Allocator& alloc, Type* first, Type* last, Type* dest) {
+    if constexpr (kIsTriviallyRelocatable<Type>) {
+        if (!IsConstantEvaluated()) {
+            const size_t count = static_cast<size_t>(last - first);
+            if (count > 0) {
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(Type));
+            }
+            return dest + count;
+        }
+    }
+    Type* result = UninitializedMoveIfNoexcept(alloc, first, last, dest);
+    DestroyRange(alloc, first, last);
+    return result;
+}
+
+// Побайтово сдвигает элементы [first, last) в dest внутри одного буфера (диапазоны могут перекрываться).
+// Только для тривиально перемещаемых типов: освобождённые позиции считаются неинициализированными
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR void RelocateOverlapping(Type* first, Type* last, Type* dest) noexcept {
+    static_assert(kIsTriviallyRelocatable<Type>);
+    // пустой диапазон может быть задан нулевыми указателями, которые нельзя отдавать memmove.
+    // Явная проверка nullptr нужна и GCC: иначе при -O3 на невозможном пути он предупреждает -Wnonnull
+    if (first == last || first == nullptr) {
+        return;
+    }
+    const size_t count = static_cast<size_t>(last - first);
+#if defined(SIMPLE_VECTOR_HAS_CONSTEXPR)
+    if (IsConstantEvaluated()) {
+        // по одному элементу в сторону, не затирающую ещё не перенесённые
+        for (size_t i = 0; i < count; ++i) {
+            const size_t j = dest < first ? i : count - 1 - i;
+            std::construct_at(dest + j, std::move(first[j]));
+            std::destroy_at(first + j);
+        }
+        return;
+    }
+#endif
+    std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(Type));
+}
+
+// Прямой итератор, который count раз возвращает одно и то же значение.
+// Позволяет реализовать вставку count копий через общий код вставки диапазона
+template <typename Type>
+class RepeatIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Type*;
+    using reference = const Type&;
+
+    SIMPLE_VECTOR_CONSTEXPR RepeatIterator(const Type* value, size_t index) noexcept
+        : value_(value), index_(index) {
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR reference operator*() const noexcept {
+        return *value_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR pointer operator->() const noexcept {
+        return value_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR RepeatIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR RepeatIterator operator++(int) noexcept {
+        RepeatIterator copy = *this;
+        ++index_;
+        return copy;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR bool operator==(const RepeatIterator& other) const noexcept {
+        return index_ == other.index_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR bool operator!=(const RepeatIterator& other) const noexcept {
+        return index_ != other.index_;
+    }
+
+private:
+    const Type* value_;
+    size_t index_;
+};
+
+} // namespace simple_vector_detail